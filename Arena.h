@@ -0,0 +1,72 @@
+#ifndef _arena_h
+#define _arena_h
+#include <vector>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <utility>
+using namespace std;
+
+/* Bump allocator that owns the objects built for a CFG. Addresses stay valid until
+ * the arena is destroyed, which runs the destructors in reverse order of creation */
+class Arena{
+    static const size_t BLOCK = 64*1024;
+    struct Dtor{
+        void *obj;
+        void (*run)(void*);
+    };
+    vector<char*> blocks;
+    vector<Dtor> dtors;
+    char *cur;
+    size_t left;
+    size_t used;
+    size_t reserved;
+    size_t objects;
+
+    template<class T>
+    static void destroy(void *p){
+        static_cast<T*>(p)->~T();
+    }
+    void *allocate(size_t size, size_t align){
+        size_t pad = (align-(size_t)cur%align)%align;
+        if(cur==NULL||pad+size>left){
+            size_t n = size+align>BLOCK?size+align:BLOCK;
+            cur = (char*)malloc(n);
+            if(cur==NULL)
+                throw bad_alloc();
+            blocks.push_back(cur);
+            left = n;
+            reserved += n;
+            pad = (align-(size_t)cur%align)%align;
+        }
+        void *p = cur+pad;
+        cur += pad+size;
+        left -= pad+size;
+        used += size;
+        return p;
+    }
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+public:
+    Arena():cur(NULL),left(0),used(0),reserved(0),objects(0){}
+    ~Arena(){
+        for(size_t i=dtors.size();i>0;i--)
+            dtors[i-1].run(dtors[i-1].obj);
+        for(size_t i=0;i<blocks.size();i++)
+            free(blocks[i]);
+    }
+    template<class T, class... Args>
+    T *make(Args&&... args){
+        void *p = allocate(sizeof(T), alignof(T));
+        T *obj = new(p) T(std::forward<Args>(args)...);
+        Dtor d = {obj, &Arena::destroy<T>};
+        dtors.push_back(d);
+        objects++;
+        return obj;
+    }
+    size_t bytesUsed() const{ return used; }
+    size_t bytesReserved() const{ return reserved; }
+    size_t size() const{ return objects; }
+};
+
+#endif
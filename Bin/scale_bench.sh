@@ -0,0 +1,61 @@
+#!/bin/bash
+# Scaling benchmark of the CFG construction: generates controller-like programs of
+# increasing size, checks each with BRICK and prints LOC, CFG size, build time and
+# peak memory (after the build and after the verification).
+# usage: ./scale_bench.sh [bound] [extra BRICK options], sizes in LOC via SIZES
+# States past the bound are not built, so give a bound of a few per function
+# (e.g. 4000 for 10000 LOC) to measure the construction of the whole program.
+# The 200-LOC limit of BRICK is lifted with -x 0.
+bound=${1:-20}
+[ $# -gt 0 ] && shift
+sizes=${SIZES:-"200 1000 2000 5000 10000"}
+dir="scale_bench"
+if [ ! -d "$dir" ]; then
+	mkdir "$dir"
+fi
+
+# a chain of saturating controller steps, about 12 lines each
+generate(){
+	local n=$1
+	local file=$2
+	echo "#include <assert.h>" > $file
+	echo "extern int __VERIFIER_nondet_int();" >> $file
+	for ((i=0;i<n;i++)); do
+		cat >> $file <<EOF
+int ctrl$i(int x){
+	int y = x * 3 + $i;
+	if(y > 3000)
+		y = 3000;
+	else if(y < -3000)
+		y = -3000;
+	else
+		y = y / 2;
+	return y;
+}
+
+EOF
+	done
+	echo "int main(){" >> $file
+	echo "	int x = __VERIFIER_nondet_int();" >> $file
+	for ((i=0;i<n;i++)); do
+		echo "	x = ctrl$i(x);" >> $file
+	done
+	echo "	assert(x <= 3000);" >> $file
+	echo "	return 0;" >> $file
+	echo "}" >> $file
+}
+
+printf "%-8s%-8s%-24s%-14s%-14s%-14s\n" "target" "#Loc" "CFG" "build(ms)" "build(MB)" "total(MB)"
+for loc in $sizes; do
+	n=$((loc/12))
+	name="$dir/ctrl_$loc"
+	generate $n $name.c
+	log=$name.log
+	./BRICK $name.c -f main -b $bound -p 0.001 -x 0 "$@" > $log 2>&1
+	cfgLoc=$(grep "#BUILDCFG Size:" $log | awk '{print $3}')
+	size=$(grep "#BUILDCFG Size:" $log | awk '{print $5"s/"$7"t"}')
+	build=$(grep "#BUILDCFG Time:" $log | awk '{print $3}' | sed 's/ms//')
+	buildMem=$(grep "#BUILDCFG Memory:" $log | awk '{print $3}')
+	mem=$(grep "#Memory used:" $log | awk '{print $3}')
+	printf "%-8s%-8s%-24s%-14s%-14s%-14s\n" "$loc" "${cfgLoc:--}" "${size:--}" "${build:--}" "${buildMem:--}" "${mem:--}"
+done
@@ -1,4 +1,6 @@
 #include "CFG.h"
+#include "CFGCache.h"
+#include <unordered_map>
 using namespace std;
 int Transition::tran_id = 0;
 
@@ -10,14 +12,14 @@ void printPath(CFG *cfg, vector<int> path){
         State *s = cfg->searchState(id);
         if(s==NULL) cerr<<"printPath state error "<<id<<"\n";
         if(i<path.size()-1){
-            cerr<<s->name<<"->";
+            cerr<<symbolTable.str(s->name)<<"->";
             Transition *t = cfg->searchTransition(path[++i]);
             if(t==NULL) cerr<<"\nprintPath transition error "<<path[i]<<"\n";
             assert(t!=NULL);
             cerr<<t->name<<"->";
         }
         else
-            cerr<<s->name<<"("<<s->ID<<")"<<endl;
+            cerr<<symbolTable.str(s->name)<<"("<<s->ID<<")"<<endl;
     }
 }
 
@@ -27,6 +29,7 @@ void CFG::InsertCFGState(int id,string name,string funcName)
     this->stateMap.insert(pair<int,State*>(tmp->ID,tmp));
 }
 
+SymbolTable symbolTable;
 CFG  global_CFG;
 
 
@@ -36,94 +39,236 @@ CFG  global_CFG;
  }
 
 void CFG::InsertCFGLabel(string Label, State *s){
-    LabelMap.insert( pair<string,State*> (Label,s));
-
-        for(unsigned int i=0;i<transitionList.size();i++){
-
-                if(transitionList[i].toLabel == Label&&transitionList[i].toState==NULL)
-                {                   
-                    transitionList[i].toName = s->name;
-                    transitionList[i].toState = s;
-                    //errs()<<"SLOT%"<<Label<<"\tsName:\t"<<s->name<<"\n\n\n";
-                };
-        }   
-        for(unsigned int i=0;i<stateList.size();i++)
-        {
-            State s1= stateList[i];
-            for(unsigned int j=0;j<s1.transList.size();j++)
-            {
-                if(s1.transList[j]->toLabel == Label && s1.transList[j]->toState == NULL)
-                {
-                    s1.transList[j]->toName = s->name;
-                    s1.transList[j]->toState = s;
-                }
+    LabelMap.insert( pair<Symbol,State*> (symbolTable.intern(Label),s));
+    resolveLabel(Label, s);
+}
+
+//add tr to s->transList and transitionList, an unresolved target label is recorded for resolveLabel
+void CFG::addTransition(State *s, Transition *tr){
+    s->transList.push_back(tr);
+    transitionList.push_back(tr);
+    if(tr->toState==NULL&&tr->toLabel!=0)
+        pendingLabels[tr->toLabel].push_back(tr);
+}
+
+//patch the transitions waiting for Label, return true if any of them was still unresolved
+bool CFG::resolveLabel(string Label, State *s){
+    unordered_map<Symbol,vector<Transition*> >::iterator it = pendingLabels.find(symbolTable.lookup(Label));
+    if(it==pendingLabels.end())
+        return false;
+    bool patched = false;
+    vector<Transition*> &p = it->second;
+    for(unsigned int i=0;i<p.size();i++){
+        Transition *tr = p[i];
+        if(tr->toState!=NULL)
+            continue;
+        tr->toName = s->name;
+        tr->toState = s;
+        s->level = tr->level;
+        patched = true;
+    }
+    pendingLabels.erase(it);
+    return patched;
+}
+
+//site number of a call to func entered at level, -1 if the call copies the body as without
+//-summary: the start function, a callee whose body is still being built (a recursive call) and
+//a call shallower than the one the body was built for, whose copy reaches further under the bound
+int CFG::shareCall(string func, int level){
+    if(!summarize||func==startFunc)
+        return -1;
+    CallSummary &sum = summaries[symbolTable.intern(func)];
+    if(sum.sites==0)
+        sum.level = level;
+    else if(!sum.built||level<sum.level)
+        return -1;
+    return sum.sites++;
+}
+
+//func.__callsite op site
+Constraint CFG::siteConstraint(string func, int site, Operator op){
+    string varName = func+".__callsite";
+    if(!hasVariable(varName)){
+        Variable var(varName, counter_variable++, INT, 32);
+        variableList.push_back(var);
+    }
+    Constraint c;
+    c.op = op;
+    c.lpvList.rvar = terms.var(getVariable(varName));
+    c.rpvList.rvar = terms.var(intToString(site), -1, INTNUM, 32u);
+    return c;
+}
+
+//copy the returns of the shared body of func to label, the continuation of call site site:
+//the returned value is assigned to ret instead of the variable of the first call
+void CFG::bindReturns(string func, int site, string ret, string label){
+    CallSummary &sum = summaries[symbolTable.intern(func)];
+    Variable *retVariable = hasVariable(ret)?terms.var(getVariable(ret)):NULL;
+    string siteName = func+".__callsite";
+    for(unsigned i=0;i<sum.rets.size();i++){
+        Transition *ret0 = sum.rets[i];
+        int t = counter_transition++;
+        Transition *tr = arena.make<Transition>(t, "e"+intToString(t));
+        tr->fromState = ret0->fromState;
+        tr->fromName = ret0->fromName;
+        tr->level = ret0->level;
+        tr->toLabel = symbolTable.intern(label);
+        tr->toState = NULL;
+        for(unsigned j=0;j<ret0->guardList.size();j++){
+            Constraint &g = ret0->guardList[j];
+            if(g.lpvList.rvar!=NULL&&g.lpvList.rvar->name==siteName)
+                tr->guardList.push_back(siteConstraint(func, site, EQ));
+            else{
+                tr->guardList.push_back(g);
+                if(g.op==ASSIGN&&retVariable!=NULL)
+                    tr->guardList.back().lpvList.rvar = retVariable;
             }
         }
-        errs()<<"func\t"<<Label <<"\t"<< s->name<<"\n";
+        addTransition(tr->fromState, tr);
+    }
+}
+
+unsigned TermTable::node(const vector<unsigned> &key){
+    unordered_map<vector<unsigned>, unsigned, KeyHash>::iterator it = terms.find(key);
+    if(it!=terms.end())
+        return it->second;
+    unsigned id = terms.size()+1;
+    terms.insert(make_pair(key, id));
+    return id;
+}
+
+Variable *TermTable::intern(const Variable &v){
+    vector<pair<Variable*, unsigned> > &same = vars[v.name];
+    for(unsigned i=0;i<same.size();i++){
+        Variable *w = same[i].first;
+        if(w->ID==v.ID&&w->type==v.type&&w->numbits==v.numbits)
+            return w;
+    }
+    Variable *w = arena.make<Variable>(v);
+    vector<unsigned> key;
+    key.push_back(0);
+    key.push_back(nvars++);
+    same.push_back(make_pair(w, node(key)));
+    return w;
+}
+
+unsigned TermTable::term(const Variable *v){
+    if(v==NULL)
+        return 0;
+    vector<pair<Variable*, unsigned> > &same = vars[v->name];
+    for(unsigned i=0;i<same.size();i++){
+        Variable *w = same[i].first;
+        if(w->ID==v->ID&&w->type==v->type&&w->numbits==v->numbits)
+            return same[i].second;
+    }
+    intern(*v);
+    return same.back().second;
+}
+
+unsigned TermTable::term(const ParaVariable &pv){
+    vector<unsigned> key;
+    key.push_back(1);
+    key.push_back(pv.isExp);
+    key.push_back(pv.op);
+    key.push_back(term(pv.lvar));
+    key.push_back(term(pv.rvar));
+    for(unsigned i=0;i<pv.varList.size();i++)
+        key.push_back(term(pv.varList[i]));
+    return node(key);
+}
+
+unsigned TermTable::term(const Constraint &c){
+    vector<unsigned> key;
+    key.push_back(2);
+    key.push_back(c.op);
+    key.push_back(term(c.lpvList));
+    key.push_back(term(c.rpvList));
+    return node(key);
+}
+
+unsigned TermTable::term(vector<Constraint> &consList){
+    vector<unsigned> key;
+    key.push_back(3);
+    for(unsigned i=0;i<consList.size();i++){
+        consList[i].term = term(consList[i]);
+        key.push_back(consList[i].term);
+    }
+    return node(key);
 }
 
 //stateList&transitionList----->Map
 bool CFG::initial(){
     stateMap.clear();
-    stateStrMap.clear();
-    nameMap.clear();
     transitionMap.clear();
-    transitionStrMap.clear();
+    stateIndex.clear();
+    transitionIndex.clear();
     this->counter_transition = 0;    
 /*
         for(int i=0;i<stateList.size();i++)
-        errs()<<stateList[i]<<"\n";
+        errs()<<*stateList[i]<<"\n";
     
         for(int i=0;i<transitionList.size();i++)
-        errs()<<transitionList[i]<<"\n";
+        errs()<<*transitionList[i]<<"\n";
 */
-    int count=1;
+    //resolve the endpoints of the transitions through a table indexed by the symbol of the name
+    vector<State*> byName(symbolTable.size(), NULL);
+    stateIndex.resize(stateList.size());
+    int count=0;
     for(unsigned int i=0;i<stateList.size();i++){    
-        State* st=&stateList[i];
-//        errs()<<st->ID<<"\t"<<st->nextS<<"\n";
+        //an ID the parser gave up leaves its slot empty
+        if(stateList[i]==NULL)
+            stateList[i]=arena.make<State>();
+        State* st=stateList[i];
         st->transList.clear();
-        if(i==0){
-//            initialState=st;
-            st->ID=0;
-//            st->isInitial=true;
-        }
-        else
-            st->ID=count++;    
+        st->ID=count++;    
         if(st->isInitial)
             initialState=st;
-        stateMap.insert(pair<int, State*>(st->ID, st));
-        stateStrMap.insert(pair<string, State*>(st->name, st));
-        nameMap.insert(pair<int, string>(st->ID, st->name));
-        for(unsigned int j=0;j<transitionList.size();j++){
-            Transition* tran=&transitionList[j];
-            if(st->name==tran->fromName){
-                st->transList.push_back(tran);
-                tran->fromState=st;
-            }
-            else if(st->name==tran->toName){                
-                tran->toState=st;
-            }
-        }
+        stateIndex[st->ID]=st;
+        byName[st->name]=st;
     }
+    transitionIndex.resize(transitionList.size());
     for(unsigned int i=0;i<transitionList.size();i++){
-        Transition* tran=&transitionList[i];
+        Transition* tran=transitionList[i];
         tran->ID=count++;        
-        transitionMap.insert(pair<int, Transition*>(tran->ID,tran));
-        transitionStrMap.insert(pair<string, Transition*>(tran->name, tran));
-        nameMap.insert(pair<int, string>(tran->ID, tran->name));
+        transitionIndex[i]=tran;
+        if(State *from=byName[tran->fromName]){
+            from->transList.push_back(tran);
+            tran->fromState=from;
+        }
+        if(State *to=byName[tran->toName])
+            tran->toState=to;
         if(tran->toState==NULL){
             errs()<<"warning: can not find the tostate of the transition: "<<tran->name<<"\n";
-            errs()<<tran->name<<" toLabel "<<tran->toLabel<<"\n";
+            errs()<<tran->name<<" toLabel "<<symbolTable.str(tran->toLabel)<<"\n";
 //            return false;
         }
     }
     if(initialState==NULL){
         errs()<<"Warning: there is no initial state.\n";
-        State* st=&stateList[0];
+        State* st=stateList[0];
         st->isInitial=true;
         initialState=st;
 //        return false;
     }
+    succOffset.assign(stateList.size()+1, 0);
+    for(unsigned int i=0;i<stateList.size();i++)
+        succOffset[i+1]=succOffset[i]+stateList[i]->transList.size();
+    succTrans.resize(succOffset.back());
+    succState.resize(succOffset.back());
+    for(unsigned int i=0;i<stateList.size();i++){
+        vector<Transition*> &out=stateList[i]->transList;
+        for(unsigned int j=0;j<out.size();j++){
+            succTrans[succOffset[i]+j]=out[j]->ID;
+            succState[succOffset[i]+j]=out[j]->toState?out[j]->toState->ID:-1;
+        }
+    }
+    nodeTerms.resize(stateList.size()+transitionList.size());
+    for(unsigned int i=0;i<stateList.size();i++)
+        nodeTerms[i] = terms.term(stateList[i]->consList);
+    for(unsigned int i=0;i<transitionList.size();i++)
+        nodeTerms[stateList.size()+i] = terms.term(transitionList[i]->guardList);
+    //index the variables now, so getVariable/hasVariable only read during the verification
+    indexVariables();
 //    errs()<<"cfg initialed~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n";
     return true;    
 
@@ -152,126 +297,183 @@ bool CFG::is_state(const int ID){
       return true;
     return false;
 }
-bool CFG::hasVariable(string name){
-    for(unsigned int i = 0; i < variableList.size(); i ++){
-        if(variableList[i].name == name)
-            return true;
+void CFG::indexVariables(){
+    if(varIndexed > variableList.size()){
+        varIndex.clear();
+        varIndexed = 0;
     }
-    return false;
+    //a later variable of the same name shadows the earlier one, as the linear scan did
+    for(; varIndexed < variableList.size(); varIndexed ++)
+        varIndex[variableList[varIndexed].name] = varIndexed;
+}
+bool CFG::hasVariable(string name){
+    indexVariables();
+    return varIndex.count(name)!=0;
 }
 Variable* CFG::getVariable(string name){
-    Variable* var = NULL;
-    for(unsigned int i = 0; i < variableList.size(); i ++){
-        if(variableList[i].name == name)
-            var = &(variableList[i]);
-    }
-    return var;
+    indexVariables();
+    unordered_map<string,int>::iterator it = varIndex.find(name);
+    if(it == varIndex.end())
+        return NULL;
+    return &(variableList[it->second]);
 }
+//names are always loaded, a lazy node is not materialized for them
 string CFG::getNodeName(int i){
-    if(nameMap.find(i)==nameMap.end())
-        return string();
-    return nameMap[i];
+    if(i>=0&&(unsigned)i<stateIndex.size())
+        return symbolTable.str(stateIndex[i]->name);
+    int j=i-(int)stateIndex.size();
+    if(j>=0&&(unsigned)j<transitionIndex.size())
+        return transitionIndex[j]->name;
+    if(State *st=searchState(i))
+        return symbolTable.str(st->name);
+    if(Transition *tr=searchTransition(i))
+        return tr->name;
+    return string();
 }
+//states registered by InsertCFGState before initial() are only in the map
 State* CFG::searchState(int stateID) {
-    if(stateMap.find(stateID)==stateMap.end())
-        return NULL;
-    return stateMap[stateID];
+    if(stateID>=0&&(unsigned)stateID<stateIndex.size()){
+        if(lazySource)
+            materialize(stateID);
+        return stateIndex[stateID];
+    }
+    map<int,State*>::iterator it=stateMap.find(stateID);
+    return it==stateMap.end()?NULL:it->second;
 }
 
 Transition* CFG::searchTransition(int transID) {        
-    if(transitionMap.find(transID)==transitionMap.end())
-        return NULL;
-    return transitionMap[transID];
+    int i=transID-(int)stateIndex.size();
+    if(i>=0&&(unsigned)i<transitionIndex.size()){
+        if(lazySource)
+            materialize(transID);
+        return transitionIndex[i];
+    }
+    map<int,Transition*>::iterator it=transitionMap.find(transID);
+    return it==transitionMap.end()?NULL:it->second;
+}
+
+CFG::~CFG(){
+    delete lazySource;
+}
+
+//take over a cache loaded lazily, after initial()
+void CFG::setLazySource(CFGCache *source){
+    lazySource = source;
+    vector<atomic<char> > flags(stateList.size()+transitionList.size());
+    for(unsigned i=0;i<flags.size();i++)
+        flags[i] = 0;
+    materialized.swap(flags);
+}
+
+void CFG::materialize(int ID){
+    if(materialized[ID].load(memory_order_acquire))
+        return;
+    lock_guard<mutex> guard(lazyLock);
+    if(materialized[ID].load(memory_order_relaxed))
+        return;
+    lazySource->materialize(this, ID);
+    if(ID<(int)stateList.size())
+        nodeTerms[ID] = terms.term(stateList[ID]->consList);
+    else
+        nodeTerms[ID] = terms.term(transitionList[ID-stateList.size()]->guardList);
+    materialized[ID].store(1, memory_order_release);
+}
+
+void CFG::materializeAll(){
+    if(lazySource==NULL)
+        return;
+    for(unsigned i=0;i<materialized.size();i++)
+        materialize(i);
 }
 
 
 raw_ostream& operator << (raw_ostream& os,Op_m& object){
     switch(object){
-        case TRUNC:errs()<<" trunc ";break;
-        case ZEXT:errs()<<" zext ";break;
-        case SEXT:errs()<<" sext ";break;
-        case FPTRUNC:errs()<<" fptrunc ";break;
-        case FPEXT:errs()<<" fpext ";break;
-        case FPTOUI:errs()<<" fptoui ";break;
-        case FPTOSI:errs()<<" fptosi ";break;
-        case UITOFP:errs()<<" uitofp ";break;
-        case SITOFP:errs()<<" sitofp ";break;
-        case BITCAST:errs()<<" bitcast ";break;
-        case ADD:case FADD:errs()<<" + ";break;
-        case SUB:case FSUB:errs()<<" - ";break;
-        case AND:errs()<<" and ";break;
-        case NAND:errs()<<" nand ";break;
-        case OR:errs()<<" or ";break;
-        case XOR:errs()<<" xor ";break;
-        case TAN:errs()<<" tan ";break;
-        case ATAN:errs()<<" atan ";break;
-        case ATAN2:errs()<<" atan2 ";break;
-        case SIN:errs()<<" sin ";break;
-        case ASIN:errs()<<" asin ";break;
-        case COS:errs()<<" cos ";break;
-        case ACOS:errs()<<" acos ";break;
-        case SQRT:errs()<<" sqrt ";break;
-        case POW:errs()<<" pow ";break;
-        case LOG:errs()<<" log ";break;
-        case LOG10:errs()<<" log10 ";break;
-        case ABS:errs()<<" abs ";break;
-        case FABS:errs()<<" fabs ";break;
-        case EXP:errs()<<" exp ";break;
-        case SINH:errs()<<" sinh ";break;
-        case COSH:errs()<<" cosh ";break;
-        case TANH:errs()<<" tanh ";break;
-        case MUL:case FMUL:errs()<<" * ";break;
-        case SDIV:case UDIV:case FDIV:errs()<<" / ";break;
-        case GETPTR:errs()<<" getptr ";break;
-        case ADDR:errs()<<" addr ";break;
-        case STORE:errs()<<" store ";break;
-        case LOAD:errs()<<" load ";break;
-        case ALLOCA:errs()<<" alloca ";break;
-        case SREM:case UREM:case FREM:errs()<<" % ";break;
-        case ASHR:case LSHR:errs()<<" >> ";break;
-        case SHL:errs()<<" << ";break;
-        case slt:case ult:case flt:errs()<<" < ";break;
-        case sle:case ule:case fle:errs()<<" <= ";break;
-        case sgt:case ugt:case fgt:errs()<<" > ";break;
-        case sge:case uge:case fge:errs()<<" >= ";break;
-        case eq:case feq:errs()<<" == ";break;
-        case ne:case fne:errs()<<" != ";break;
-        case MKNAN:errs()<<" nan ";break;
-        case ISNAN:errs()<<" isnan ";break;
-        case ISINF:errs()<<" isinf ";break;
-        case ISNORMAL:errs()<<" isnormal ";break;
-        case ISFINITE:errs()<<" isfinite ";break;
-        case SIGNBIT:errs()<<" signbit ";break;
-        case CLASSIFY:errs()<<" fpclassify ";break;
-        case COPYSIGN:errs()<<" copysign ";break;
-        case FESETROUND:errs()<<" fesetround ";break;
-        case FEGETROUND:errs()<<" fegetround ";break;
-        case CEIL:errs()<<" ceil ";break;
-        case FLOOR:errs()<<" floor ";break;
-        case ROUND:errs()<<" round ";break;
-        case NEARBYINT:errs()<<" nearbyint ";break;
-        case RINT:errs()<<" rint ";break;
-        case FMAX:errs()<<" fmax ";break;
-        case FMIN:errs()<<" fmin ";break;
-        case FMOD:errs()<<" fmod ";break;
-        case FDIM:errs()<<" fdim ";break;
-        case REMAINDER:errs()<<" remainder ";break;
-        case MODF:errs()<<" modf ";break;
-        case FUNCTRUNC:errs()<<" functrunc ";break;
-        case NONE:errs()<<" ";break;
+        case TRUNC:os<<" trunc ";break;
+        case ZEXT:os<<" zext ";break;
+        case SEXT:os<<" sext ";break;
+        case FPTRUNC:os<<" fptrunc ";break;
+        case FPEXT:os<<" fpext ";break;
+        case FPTOUI:os<<" fptoui ";break;
+        case FPTOSI:os<<" fptosi ";break;
+        case UITOFP:os<<" uitofp ";break;
+        case SITOFP:os<<" sitofp ";break;
+        case BITCAST:os<<" bitcast ";break;
+        case ADD:case FADD:os<<" + ";break;
+        case SUB:case FSUB:os<<" - ";break;
+        case AND:os<<" and ";break;
+        case NAND:os<<" nand ";break;
+        case OR:os<<" or ";break;
+        case XOR:os<<" xor ";break;
+        case TAN:os<<" tan ";break;
+        case ATAN:os<<" atan ";break;
+        case ATAN2:os<<" atan2 ";break;
+        case SIN:os<<" sin ";break;
+        case ASIN:os<<" asin ";break;
+        case COS:os<<" cos ";break;
+        case ACOS:os<<" acos ";break;
+        case SQRT:os<<" sqrt ";break;
+        case POW:os<<" pow ";break;
+        case LOG:os<<" log ";break;
+        case LOG10:os<<" log10 ";break;
+        case ABS:os<<" abs ";break;
+        case FABS:os<<" fabs ";break;
+        case EXP:os<<" exp ";break;
+        case SINH:os<<" sinh ";break;
+        case COSH:os<<" cosh ";break;
+        case TANH:os<<" tanh ";break;
+        case MUL:case FMUL:os<<" * ";break;
+        case SDIV:case UDIV:case FDIV:os<<" / ";break;
+        case GETPTR:os<<" getptr ";break;
+        case ADDR:os<<" addr ";break;
+        case STORE:os<<" store ";break;
+        case LOAD:os<<" load ";break;
+        case ALLOCA:os<<" alloca ";break;
+        case SREM:case UREM:case FREM:os<<" % ";break;
+        case ASHR:case LSHR:os<<" >> ";break;
+        case SHL:os<<" << ";break;
+        case slt:case ult:case flt:os<<" < ";break;
+        case sle:case ule:case fle:os<<" <= ";break;
+        case sgt:case ugt:case fgt:os<<" > ";break;
+        case sge:case uge:case fge:os<<" >= ";break;
+        case eq:case feq:os<<" == ";break;
+        case ne:case fne:os<<" != ";break;
+        case MKNAN:os<<" nan ";break;
+        case ISNAN:os<<" isnan ";break;
+        case ISINF:os<<" isinf ";break;
+        case ISNORMAL:os<<" isnormal ";break;
+        case ISFINITE:os<<" isfinite ";break;
+        case SIGNBIT:os<<" signbit ";break;
+        case CLASSIFY:os<<" fpclassify ";break;
+        case COPYSIGN:os<<" copysign ";break;
+        case FESETROUND:os<<" fesetround ";break;
+        case FEGETROUND:os<<" fegetround ";break;
+        case CEIL:os<<" ceil ";break;
+        case FLOOR:os<<" floor ";break;
+        case ROUND:os<<" round ";break;
+        case NEARBYINT:os<<" nearbyint ";break;
+        case RINT:os<<" rint ";break;
+        case FMAX:os<<" fmax ";break;
+        case FMIN:os<<" fmin ";break;
+        case FMOD:os<<" fmod ";break;
+        case FDIM:os<<" fdim ";break;
+        case REMAINDER:os<<" remainder ";break;
+        case MODF:os<<" modf ";break;
+        case FUNCTRUNC:os<<" functrunc ";break;
+        case NONE:os<<" ";break;
     }
     return os;
 }
 
 raw_ostream& operator << (raw_ostream& os,Err& object){
     switch(object){
-        case Assert:errs()<<" Assert Error ";break;
-        case Spec:errs()<<" Spec Error ";break;
-        case Div0:errs()<<" Div0 Error ";break;
-        case DomainLog:errs()<<" DomainLog Error ";break;
-        case DomainSqrt:errs()<<" DomainSqrt Error ";break;
-        case DomainTri:errs()<<" DomainTri Error ";break;
-        case Noerr:errs()<<" No Error ";break;
+        case Assert:os<<" Assert Error ";break;
+        case Spec:os<<" Spec Error ";break;
+        case Div0:os<<" Div0 Error ";break;
+        case DomainLog:os<<" DomainLog Error ";break;
+        case DomainSqrt:os<<" DomainSqrt Error ";break;
+        case DomainTri:os<<" DomainTri Error ";break;
+        case Noerr:os<<" No Error ";break;
     }
     return os;
 }
@@ -425,13 +627,13 @@ raw_ostream&  operator << (raw_ostream& os,ParaVariable& object){
 
 raw_ostream& operator << (raw_ostream& os,Operator& object){
     switch(object){
-        case SLT:case ULT:case FLT:errs()<<" < ";break;
-        case SLE:case ULE:case FLE:errs()<<" <= ";break;
-        case SGT:case UGT:case FGT:errs()<<" > ";break;
-        case SGE:case UGE:case FGE:errs()<<" >= ";break;
-        case EQ:case FEQ:errs()<<" == ";break;
-        case NE:case FNE:errs()<<" != ";break;
-        case ASSIGN:errs()<<" = ";break;
+        case SLT:case ULT:case FLT:os<<" < ";break;
+        case SLE:case ULE:case FLE:os<<" <= ";break;
+        case SGT:case UGT:case FGT:os<<" > ";break;
+        case SGE:case UGE:case FGE:os<<" >= ";break;
+        case EQ:case FEQ:os<<" == ";break;
+        case NE:case FNE:os<<" != ";break;
+        case ASSIGN:os<<" = ";break;
     }
     return os;
 }
@@ -450,8 +652,8 @@ raw_ostream& operator << (raw_ostream& os,Constraint& object){
 raw_ostream& operator << (raw_ostream& os, Transition object){
     errs()<<"Transition Name:"<<object.name<<" ID:"<<object.ID<<"\n";
     errs()<<"Level:"<<object.level<<"\n";
-    errs()<<"ToLabel:"<<object.toLabel<<"\n";
-    errs()<<"from:"<<object.fromName<<" to:"<<object.toName<<"\nGuard:\n";
+    errs()<<"ToLabel:"<<symbolTable.str(object.toLabel)<<"\n";
+    errs()<<"from:"<<symbolTable.str(object.fromName)<<" to:"<<symbolTable.str(object.toName)<<"\nGuard:\n";
     if(object.guardList.empty())
         errs()<<"null\n";
     else{
@@ -463,7 +665,7 @@ raw_ostream& operator << (raw_ostream& os, Transition object){
 }
 
 raw_ostream& operator << (raw_ostream& os, State object){
-    errs()<<"Location Name:"<<object.funcName<<" "<<object.name<<" ID:"<<object.ID<<" nextS:"<<object.nextS<<"\n";
+    errs()<<"Location Name:"<<symbolTable.str(object.funcName)<<" "<<symbolTable.str(object.name)<<" ID:"<<object.ID<<" nextS:"<<object.nextS<<"\n";
     errs()<<"Level:"<<object.level<<"\n";
     errs()<<"ErrorType:"<<object.error<<"\n";
     if(object.isInitial)
@@ -480,6 +682,7 @@ raw_ostream& operator << (raw_ostream& os, State object){
 }
 
 void CFG::print(){
+    materializeAll();
     errs()<<"*******************CFG Information*********************\n";
     errs()<<"CFG:"<<name<<"\n";
     printLinearMode();
@@ -512,9 +715,9 @@ void CFG::print(){
     }
     errs()<<"\n";
     for(unsigned int i=0;i<stateList.size();i++)
-          errs()<<stateList[i]<<"\n";
+          errs()<<*stateList[i]<<"\n";
     for(unsigned int i=0;i<transitionList.size();i++)
-        errs()<<transitionList[i]<<"\n";
+        errs()<<*transitionList[i]<<"\n";
 }   
    
 void CFG::printLinearMode(){
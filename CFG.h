@@ -7,6 +7,9 @@
 #include <list>
 #include <fstream>
 #include <map>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
 #include <stdlib.h> 
 #include <assert.h>
 #include "llvm/IR/BasicBlock.h"
@@ -18,6 +21,8 @@
 #include "convinent.h"
 #include "assert.h"
 #include "general.h"
+#include "Arena.h"
+#include "SymbolTable.h"
 
 
 using namespace std;
@@ -165,26 +170,63 @@ class Constraint{
         ParaVariable lpvList;
         ParaVariable rpvList;
         Operator op;
-        Constraint(){};
+        unsigned term;                      //hash-consed ID given by CFG::initial(), 0 before
+        Constraint(){term=0;};
         ~Constraint(){};
         Constraint& operator =(const Constraint &a){
             this->lpvList=a.lpvList;
             this->rpvList=a.rpvList;
             this->op=a.op;
+            this->term=a.term;
             return *this;
         }
         friend raw_ostream& operator<<(raw_ostream& os, Constraint& object);
 };
 
+/* Hash-consed terms of the constraints. A variable is interned by (name, ID, type, bits),
+ * so the copies the parser makes of it share one object. A term is identified by its
+ * kind, operator and the IDs of its operands, so equal sub-expressions of different
+ * nodes get the same 32-bit ID; the constraint list of a node is a term as well, and
+ * LinearVerify keys its memo of encodings on it */
+class TermTable{
+    struct KeyHash{
+        size_t operator()(const vector<unsigned> &k) const{
+            size_t h = 14695981039346656037ULL;
+            for(unsigned i=0;i<k.size();i++)
+                h = (h^k[i])*1099511628211ULL;
+            return h;
+        }
+    };
+    Arena &arena;
+    unordered_map<string, vector<pair<Variable*, unsigned> > > vars;
+    unordered_map<vector<unsigned>, unsigned, KeyHash> terms;
+    unsigned nvars;
+    unsigned node(const vector<unsigned> &key);
+public:
+    TermTable(Arena &a):arena(a),nvars(0){}
+    template<class... Args>
+    Variable *var(Args&&... args){
+        return intern(Variable(std::forward<Args>(args)...));
+    }
+    Variable *intern(const Variable &v);
+    unsigned term(const Variable *v);
+    unsigned term(const ParaVariable &pv);
+    unsigned term(const Constraint &c);
+    //stamps the constraints with their terms, returns the term of the list
+    unsigned term(vector<Constraint> &consList);
+    unsigned size() const{ return terms.size(); }
+    unsigned variables() const{ return nvars; }
+};
+
 
 class Transition;
 class State{
     public:
         bool isInitial;
         int ID;
-        string funcName;
+        Symbol funcName;                    //interned, symbolTable.str() gives the text
         int nextS;
-        string name;
+        Symbol name;
         int level;
         Err error;
         vector<Transition *> transList;     //zhuanyi List
@@ -194,8 +236,8 @@ class State{
         State(){
             this->level = -1;
             this->ID = 0;
-            this->name = "";
-            this->funcName = "";
+            this->name = 0;
+            this->funcName = 0;
             this->isInitial = false;
             nextS = -1;
             error = Noerr;
@@ -204,8 +246,8 @@ class State{
         {
             this->level = -1;
             this->ID = id;
-            this->name = name;
-            this->funcName = funcName;
+            this->name = symbolTable.intern(name);
+            this->funcName = symbolTable.intern(funcName);
             this->isInitial = false;
             nextS = -1;
             error = Noerr;
@@ -213,8 +255,8 @@ class State{
         State(bool bo,int id,string name1,string funcName1){
             isInitial = bo;
             ID = id;
-            name = name1;
-            funcName = funcName1;
+            name = symbolTable.intern(name1);
+            funcName = symbolTable.intern(funcName1);
             nextS = -1;
             level = -1;
             error = Noerr;
@@ -245,16 +287,17 @@ class Transition{
         string name;
         State* fromState;
         State* toState;
-        string fromName;
-        string toName;
-        string toLabel;
+        Symbol fromName;                    //interned like the names of State
+        Symbol toName;
+        Symbol toLabel;
         int level;
         vector<Constraint> guardList;
-        Transition(int id,string name1):ID(id),name(name1){toLabel="";level =-1;};
+        Transition(int id,string name1):ID(id),name(name1),fromName(0),toName(0),toLabel(0){level =-1;};
         Transition(string fromName,string toName)
         {
-            this->fromName = fromName;
-            this->toName = toName;
+            this->fromName = symbolTable.intern(fromName);
+            this->toName = symbolTable.intern(toName);
+            this->toLabel = 0;
             this->ID = tran_id++;
             this->level = -1;
         }
@@ -274,23 +317,59 @@ class Transition{
         friend raw_ostream& operator << (raw_ostream& os, Transition object);
 };    
 
+class CFGCache;
 class CFG{
     private:
         map<int,State*> stateMap;
         map<int,Transition*> transitionMap;
-        map<string,State*> stateStrMap;
-        map<string,Transition*> transitionStrMap;
-        map<int,string> nameMap;
+        //filled by initial(): node IDs are dense, states 0..S-1 then transitions S..S+T-1
+        vector<State*> stateIndex;
+        vector<Transition*> transitionIndex;
+        //successors of state s in CSR form: succTrans/succState[succOffset[s]..succOffset[s+1])
+        vector<int> succOffset;
+        vector<int> succTrans;
+        vector<int> succState;
+        //term of the constraint list of every node, stamped by initial() (and materialize())
+        vector<unsigned> nodeTerms;
+        //name -> position in variableList; the parser appends to variableList directly,
+        //so the entries past varIndexed are indexed on the next lookup
+        unordered_map<string,int> varIndex;
+        unsigned varIndexed;
+        void indexVariables();
+        //transitions whose target label has not been inserted yet
+        unordered_map<Symbol,vector<Transition*> > pendingLabels;
+        //lazy mode: the constraints of a node are decoded from the cache on its first lookup
+        CFGCache *lazySource;
+        vector<atomic<char> > materialized;
+        mutex lazyLock;
+        void materialize(int ID);
         bool linear;
         bool modeLock;
     public:
-        map<string,State*> LabelMap;
-        map<string,vector<string>> CallLabel;
-        map<string, int> funcTime;
-        map<string, string> endBlock;
+        //keyed by the interned names of symbolTable
+        unordered_map<Symbol,State*> LabelMap;
+        unordered_map<Symbol,vector<Symbol>> CallLabel;
+        unordered_map<Symbol, int> funcTime;
+        unordered_map<Symbol, Symbol> endBlock;
         vector<string> retVar;
         list<ParaVariable> callVar;
         list<Constraint> initialCons;
+        //-summary: the body of a callee is built once and shared by its call sites.
+        //A call assigns its site number to callee.__callsite, every return of the body
+        //is copied per site and guarded by it, so a path only returns to its own caller
+        struct CallSummary{
+            bool built;                 //the body is complete, recursive calls before that are copied
+            int sites;                  //call sites bound to the body so far
+            int level;                  //level of the entry of the body, the bound cuts it from there
+            vector<Transition*> rets;   //returns of the body
+            CallSummary():built(false),sites(0),level(0){}
+        };
+        bool summarize;
+        unordered_map<Symbol,CallSummary> summaries;
+        vector<int> callSite;           //site of the pending call, -1 if the callee is copied; pushed with retVar
+        int shareCall(string func, int level);
+        Constraint siteConstraint(string func, int site, Operator op);
+        void bindReturns(string func, int site, string ret, string label);
         
         string name;
         string startFunc;
@@ -300,26 +379,36 @@ class CFG{
         unsigned counter_variable;
         unsigned counter_transition;
         State* initialState;
-        vector<State> stateList;
-        vector<Transition> transitionList;//at the same time  ,equals to the transList
+        //the states and transitions of the arena, a state is stored at its ID while building
+        vector<State*> stateList;
+        vector<Transition*> transitionList;
         vector<Variable> variableList;
         vector<Variable> exprList;
         vector<unsigned> mainInput;
+        //owns the states, transitions and variables the parser allocates
+        Arena arena;
+        TermTable terms;
         //vector<Transition*> transitionList1;
         Constraint c_tmp1;
         Constraint c_tmp2;
         //int transitionNum;
-        CFG(){     
+        CFG():terms(arena){     
             counter_state = 0;
             counter_variable = 0;
             counter_s_state = 0;
             counter_q_state = 0;
             counter_transition = 0;
+            varIndexed = 0;
+            lazySource = NULL;
+            summarize = false;
             linear=true;
             modeLock=false;
         }
+        ~CFG();
         void print();
         void printLinearMode();
+        void setLazySource(CFGCache *source);
+        void materializeAll();
         bool initial();
         bool is_state(const int ID);
         bool isLinear();
@@ -331,27 +420,38 @@ class CFG{
         void InsertCFGState(int id,string name,string funcName);
         void InsertCFGTransition(Transition* tr);
         void InsertCFGLabel(string Label, State *s);
+        void addTransition(State *s, Transition *tr);
+        bool resolveLabel(string Label, State *s);
         void CFGStateConsList(int id,int op1);
-        State* getState(int id){ return stateMap.find(id)->second;};
+        State* getState(int id){ return searchState(id);};
         State* getLabelState(string Label){
-            map<string ,State* >::iterator l_it;
-            l_it=LabelMap.find(Label);
+            unordered_map<Symbol,State* >::iterator l_it;
+            l_it=LabelMap.find(symbolTable.lookup(Label));
             if(l_it==LabelMap.end())
                 return NULL;
             else
                 return l_it->second;};
         string getNodeName(int i);
+        //hash-consed term of the constraints of node i, nodes with equal constraints share it
+        unsigned nodeTerm(int i){ return nodeTerms[i]; }
         State* searchState(int stateID);
         State* searchState(string name);
         Transition* searchTransition(string name);
         Transition* searchTransition(int transID);
         Transition* searchTransitionByState(int from,int to);
+        int outDegree(int stateID){ return succOffset[stateID+1]-succOffset[stateID];};
+        int succTransition(int stateID, int k){ return succTrans[succOffset[stateID]+k];};
+        //-1 when the target of the transition was never resolved
+        int succTarget(int stateID, int k){ return succState[succOffset[stateID]+k];};
         CFG& operator =(const CFG a){
             this->name=a.name;
             this->initialState=a.initialState;
             this->stateList=a.stateList;
             this->transitionList=a.transitionList;
             this->variableList=a.variableList;
+            this->varIndex.clear();
+            this->varIndexed = 0;
+            this->pendingLabels.clear();
             this->counter_state = a.counter_state;
             this->counter_variable = a.counter_variable;
             this->counter_s_state = a.counter_s_state;
@@ -373,13 +473,24 @@ public:
 };
 
 class Verify{
+protected:
+    std::atomic<bool> canceled;
 public:
-    Verify(){};
+    Verify(){canceled=false;};
     virtual ~Verify();
     virtual bool check(CFG* ha, vector<int> &path)=0;
+    //check a path which extends or backtracks the last one, backends without push/pop encode it from scratch
+    virtual bool check_incremental(CFG* ha, vector<int> &path){return check(ha, path);}
     virtual vector<IndexPair> get_core_index()=0;
     // virtual void print_sol(CFG* cfg)=0;
     virtual double getTime()=0;
+    //a new target is checked, the backends may drop what they keep for the previous one
+    virtual void newTarget(){}
+    //abort the check running on another thread, its answer is no longer definitive
+    virtual void interrupt(){canceled=true;}
+    //whether the answer of the last check is definitive
+    virtual bool isDefinitive(){return !canceled;}
+    void resetCancel(){canceled=false;}
 };
 
 void printPath(CFG *cfg, vector<int> path);
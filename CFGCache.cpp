@@ -0,0 +1,434 @@
+#include "CFGCache.h"
+#include "llvm/Bitcode/ReaderWriter.h"
+#include "llvm/Support/FileSystem.h"
+using namespace std;
+
+static const char CFG_MAGIC[8] = {'B','R','I','C','K','C','F','G'};
+static const uint32_t CFG_VERSION = 2;
+
+/* FNV-1a */
+static void hashBytes(uint64_t &h, const void *data, size_t len){
+    const unsigned char *p = (const unsigned char *)data;
+    for(size_t i=0;i<len;i++){
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+}
+
+CFGCache::CFGCache(string dir, const Module &M, string options){
+    string bitcode;
+    raw_string_ostream os(bitcode);
+    WriteBitcodeToFile(&M, os);
+    os.flush();
+    uint64_t h = 14695981039346656037ULL;
+    hashBytes(h, bitcode.data(), bitcode.size());
+    hashBytes(h, options.data(), options.size());
+    char name[32];
+    sprintf(name, "%016llx.cfg", (unsigned long long)h);
+    if(std::error_code ec = sys::fs::create_directories(dir)){
+        errs()<<"CFGCache: can not create the cache directory "<<dir<<": "<<ec.message()<<"\n";
+        exit(1);
+    }
+    fileName = dir+"/"+name;
+    pos = 0;
+    bad = false;
+}
+
+void CFGCache::putBytes(const void *p, size_t n){
+    const char *c = (const char *)p;
+    buf.insert(buf.end(), c, c+n);
+}
+
+void CFGCache::putString(const string &s){
+    putU32(s.size());
+    putBytes(s.data(), s.size());
+}
+
+void CFGCache::collect(const Variable *v){
+    if(v==NULL||poolIndex.count(v))
+        return;
+    uint32_t index = poolIndex.size()+1;
+    poolIndex[v] = index;
+    putString(v->name);
+    putI32(v->ID);
+    putI32(v->type);
+    putU32(v->numbits);
+}
+
+void CFGCache::collect(const vector<Constraint> &consList){
+    for(unsigned i=0;i<consList.size();i++){
+        const ParaVariable *pv[2] = {&consList[i].lpvList, &consList[i].rpvList};
+        for(unsigned k=0;k<2;k++){
+            collect(pv[k]->lvar);
+            collect(pv[k]->rvar);
+            for(unsigned j=0;j<pv[k]->varList.size();j++)
+                collect(pv[k]->varList[j]);
+        }
+    }
+}
+
+//index in the pool, 0 for none
+void CFGCache::putVariable(const Variable *v){
+    putU32(v==NULL?0:poolIndex[v]);
+}
+
+void CFGCache::putPara(const ParaVariable &pv){
+    putU32(pv.isExp);
+    putI32(pv.op);
+    putVariable(pv.lvar);
+    putVariable(pv.rvar);
+    putU32(pv.varList.size());
+    for(unsigned i=0;i<pv.varList.size();i++)
+        putVariable(pv.varList[i]);
+}
+
+//length-prefixed, so that a lazy load can skip it
+void CFGCache::putConstraints(const vector<Constraint> &consList){
+    size_t start = buf.size();
+    putU32(0);
+    putU32(consList.size());
+    for(unsigned i=0;i<consList.size();i++){
+        putI32(consList[i].op);
+        putPara(consList[i].lpvList);
+        putPara(consList[i].rpvList);
+    }
+    uint32_t len = buf.size()-start-sizeof(uint32_t);
+    memcpy(&buf[start], &len, sizeof(len));
+}
+
+void CFGCache::putInts(const vector<int> &v){
+    putU32(v.size());
+    for(unsigned i=0;i<v.size();i++)
+        putI32(v[i]);
+}
+
+bool CFGCache::getBytes(void *p, size_t n){
+    if(bad||pos+n>buf.size()){
+        bad = true;
+        memset(p, 0, n);
+        return false;
+    }
+    memcpy(p, &buf[pos], n);
+    pos += n;
+    return true;
+}
+
+uint32_t CFGCache::getU32(){
+    uint32_t v;
+    getBytes(&v, sizeof(v));
+    return v;
+}
+
+int32_t CFGCache::getI32(){
+    int32_t v;
+    getBytes(&v, sizeof(v));
+    return v;
+}
+
+string CFGCache::getString(){
+    uint32_t n = getU32();
+    if(bad||pos+n>buf.size()){
+        bad = true;
+        return string();
+    }
+    string s(&buf[pos], n);
+    pos += n;
+    return s;
+}
+
+Variable *CFGCache::getVariable(CFG *cfg){
+    uint32_t index = getU32();
+    if(index==0||bad)
+        return NULL;
+    if(index>pool.size()){
+        bad = true;
+        return NULL;
+    }
+    return pool[index-1];
+}
+
+void CFGCache::getPara(CFG *cfg, ParaVariable &pv){
+    pv.isExp = getU32()!=0;
+    pv.op = (Op_m)getI32();
+    pv.lvar = getVariable(cfg);
+    pv.rvar = getVariable(cfg);
+    uint32_t n = getU32();
+    pv.varList.clear();
+    for(uint32_t i=0;i<n&&!bad;i++)
+        pv.varList.push_back(getVariable(cfg));
+}
+
+void CFGCache::getConstraints(CFG *cfg, vector<Constraint> &consList){
+    getU32();
+    uint32_t n = getU32();
+    consList.clear();
+    for(uint32_t i=0;i<n&&!bad;i++){
+        Constraint c;
+        c.op = (Operator)getI32();
+        getPara(cfg, c.lpvList);
+        getPara(cfg, c.rpvList);
+        consList.push_back(c);
+    }
+}
+
+void CFGCache::getInts(vector<int> &v){
+    uint32_t n = getU32();
+    v.clear();
+    for(uint32_t i=0;i<n&&!bad;i++)
+        v.push_back(getI32());
+}
+
+void CFGCache::getBlock(CFG *cfg, vector<Constraint> &consList, int node, bool lazy){
+    if(!lazy){
+        getConstraints(cfg, consList);
+        return;
+    }
+    blocks[node] = pos;
+    uint32_t len = getU32();
+    if(bad||pos+len>buf.size()){
+        bad = true;
+        return;
+    }
+    pos += len;
+}
+
+void CFGCache::materialize(CFG *cfg, int ID){
+    State *st = ID<(int)cfg->stateList.size()?cfg->stateList[ID]:NULL;
+    vector<Constraint> &consList = st?st->consList:cfg->transitionList[ID-cfg->stateList.size()]->guardList;
+    pos = blocks[ID];
+    bad = false;
+    getConstraints(cfg, consList);
+    if(bad){
+        errs()<<"CFGCache: "<<fileName<<" has a broken constraint block at node "<<ID<<"\n";
+        consList.clear();
+        return;
+    }
+}
+
+bool CFGCache::save(CFG *cfg, vector<int> &target, DebugInfo *dbg){
+    buf.clear();
+    poolIndex.clear();
+    putBytes(CFG_MAGIC, sizeof(CFG_MAGIC));
+    putU32(CFG_VERSION);
+
+    putString(cfg->name);
+    putString(cfg->startFunc);
+    putU32(cfg->counter_state);
+    putU32(cfg->counter_s_state);
+    putU32(cfg->counter_q_state);
+    putU32(cfg->counter_variable);
+    putU32(cfg->counter_transition);
+    putU32(cfg->isLinear());
+
+    putU32(cfg->variableList.size());
+    for(unsigned i=0;i<cfg->variableList.size();i++){
+        Variable &v = cfg->variableList[i];
+        putString(v.name);
+        putI32(v.ID);
+        putI32(v.type);
+        putU32(v.numbits);
+    }
+    putU32(cfg->exprList.size());
+    for(unsigned i=0;i<cfg->exprList.size();i++){
+        Variable &v = cfg->exprList[i];
+        putString(v.name);
+        putI32(v.ID);
+        putI32(v.type);
+        putU32(v.numbits);
+    }
+    vector<int> inputs(cfg->mainInput.begin(), cfg->mainInput.end());
+    putInts(inputs);
+
+    size_t poolAt = buf.size();
+    putU32(0);
+    for(unsigned i=0;i<cfg->stateList.size();i++)
+        collect(cfg->stateList[i]->consList);
+    for(unsigned i=0;i<cfg->transitionList.size();i++)
+        collect(cfg->transitionList[i]->guardList);
+    uint32_t poolSize = poolIndex.size();
+    memcpy(&buf[poolAt], &poolSize, sizeof(poolSize));
+
+    putU32(cfg->stateList.size());
+    for(unsigned i=0;i<cfg->stateList.size();i++){
+        State &st = *cfg->stateList[i];
+        putU32(st.isInitial);
+        putString(symbolTable.str(st.funcName));
+        putI32(st.nextS);
+        putString(symbolTable.str(st.name));
+        putI32(st.level);
+        putI32(st.error);
+        putString(st.ContentRec);
+        putInts(st.locList);
+        putConstraints(st.consList);
+    }
+    putU32(cfg->transitionList.size());
+    for(unsigned i=0;i<cfg->transitionList.size();i++){
+        Transition &tr = *cfg->transitionList[i];
+        putString(tr.name);
+        putString(symbolTable.str(tr.fromName));
+        putString(symbolTable.str(tr.toName));
+        putString(symbolTable.str(tr.toLabel));
+        putI32(tr.level);
+        putConstraints(tr.guardList);
+    }
+    putInts(target);
+
+    putString(dbg->mainFunc);
+    putU32(dbg->counter_inputvar);
+    putU32(dbg->counter_var);
+    putU32(dbg->loc);
+    putU32(dbg->callLevel);
+    putU32(dbg->curLevel);
+    putU32(dbg->funcCnt);
+    putU32(dbg->counter_op);
+    putU32(dbg->nonlinearOp.size());
+    for(map<Op_m, unsigned>::iterator it=dbg->nonlinearOp.begin();it!=dbg->nonlinearOp.end();++it){
+        putI32(it->first);
+        putU32(it->second);
+    }
+
+    //write aside and rename, a concurrent reader never sees a partial entry
+    string tmp = fileName+".tmp";
+    FILE *out = fopen(tmp.c_str(), "wb");
+    if(out==NULL){
+        errs()<<"CFGCache: can not write "<<tmp<<"\n";
+        return false;
+    }
+    bool ok = fwrite(&buf[0], 1, buf.size(), out)==buf.size();
+    ok = fclose(out)==0&&ok;
+    if(!ok||rename(tmp.c_str(), fileName.c_str())!=0){
+        errs()<<"CFGCache: can not write "<<fileName<<"\n";
+        remove(tmp.c_str());
+        return false;
+    }
+    buf.clear();
+    return true;
+}
+
+bool CFGCache::load(CFG *cfg, vector<int> &target, DebugInfo *dbg, bool lazy){
+    FILE *in = fopen(fileName.c_str(), "rb");
+    if(in==NULL)
+        return false;
+    buf.clear();
+    char chunk[1<<16];
+    size_t n;
+    while((n=fread(chunk, 1, sizeof(chunk), in))>0)
+        buf.insert(buf.end(), chunk, chunk+n);
+    fclose(in);
+    pos = 0;
+    bad = false;
+    pool.clear();
+
+    char magic[8];
+    getBytes(magic, sizeof(magic));
+    if(bad||memcmp(magic, CFG_MAGIC, sizeof(magic))!=0||getU32()!=CFG_VERSION){
+        errs()<<"CFGCache: "<<fileName<<" is not a valid cache entry, rebuild it\n";
+        return false;
+    }
+
+    cfg->name = getString();
+    cfg->startFunc = getString();
+    cfg->counter_state = getU32();
+    cfg->counter_s_state = getU32();
+    cfg->counter_q_state = getU32();
+    cfg->counter_variable = getU32();
+    cfg->counter_transition = getU32();
+    if(getU32())
+        cfg->setLinear();
+    else
+        cfg->setUnlinear();
+
+    uint32_t count = getU32();
+    for(uint32_t i=0;i<count&&!bad;i++){
+        string name = getString();
+        int id = getI32();
+        VarType type = (VarType)getI32();
+        unsigned numbits = getU32();
+        cfg->variableList.push_back(Variable(name, id, type, numbits));
+    }
+    count = getU32();
+    for(uint32_t i=0;i<count&&!bad;i++){
+        string name = getString();
+        int id = getI32();
+        VarType type = (VarType)getI32();
+        unsigned numbits = getU32();
+        cfg->exprList.push_back(Variable(name, id, type, numbits));
+    }
+    vector<int> inputs;
+    getInts(inputs);
+    cfg->mainInput.assign(inputs.begin(), inputs.end());
+
+    count = getU32();
+    for(uint32_t i=0;i<count&&!bad;i++){
+        string name = getString();
+        int id = getI32();
+        VarType type = (VarType)getI32();
+        unsigned numbits = getU32();
+        pool.push_back(cfg->terms.var(name, id, type, numbits));
+    }
+
+    count = getU32();
+    if(!bad&&count>buf.size())
+        bad = true;
+    if(!bad)
+        cfg->stateList.resize(count);
+    if(lazy)
+        blocks.assign(count, 0);
+    for(uint32_t i=0;i<count&&!bad;i++){
+        State &st = *cfg->arena.make<State>();
+        cfg->stateList[i] = &st;
+        st.isInitial = getU32()!=0;
+        st.ID = i;
+        st.funcName = symbolTable.intern(getString());
+        st.nextS = getI32();
+        st.name = symbolTable.intern(getString());
+        st.level = getI32();
+        st.error = (Err)getI32();
+        st.ContentRec = getString();
+        getInts(st.locList);
+        getBlock(cfg, st.consList, i, lazy);
+    }
+    unsigned states = cfg->stateList.size();
+    count = getU32();
+    if(!bad&&count>buf.size())
+        bad = true;
+    if(lazy&&!bad)
+        blocks.resize(states+count, 0);
+    for(uint32_t i=0;i<count&&!bad;i++){
+        Transition *tr = cfg->arena.make<Transition>(0, getString());
+        tr->fromName = symbolTable.intern(getString());
+        tr->toName = symbolTable.intern(getString());
+        tr->toLabel = symbolTable.intern(getString());
+        tr->level = getI32();
+        tr->fromState = NULL;
+        tr->toState = NULL;
+        cfg->transitionList.push_back(tr);
+        getBlock(cfg, tr->guardList, states+i, lazy);
+    }
+    getInts(target);
+
+    dbg->mainFunc = getString();
+    dbg->counter_inputvar = getU32();
+    dbg->counter_var = getU32();
+    dbg->loc = getU32();
+    dbg->callLevel = getU32();
+    dbg->curLevel = getU32();
+    dbg->funcCnt = getU32();
+    dbg->counter_op = getU32();
+    count = getU32();
+    for(uint32_t i=0;i<count&&!bad;i++){
+        Op_m op = (Op_m)getI32();
+        dbg->nonlinearOp[op] = getU32();
+    }
+    if(bad||pos!=buf.size()){
+        errs()<<"CFGCache: "<<fileName<<" is truncated, rebuild it\n";
+        buf.clear();
+        return false;
+    }
+    //the constraint blocks are still needed by a lazy load
+    if(!lazy)
+        buf.clear();
+    //relink the states and transitions and renumber them as they were saved
+    cfg->initialState = NULL;
+    return cfg->initial();
+}
@@ -0,0 +1,62 @@
+#ifndef _cfgcache_h
+#define _cfgcache_h
+#include "CFG.h"
+#include "DebugInfo.h"
+#include <stdint.h>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+//version of the CFG construction, part of the cache key: bump it whenever the parser builds a
+//different CFG for the same program and options. CFG_VERSION only describes the file format
+static const int CFG_BUILDER = 3;
+
+/* On-disk cache of the finalised CFG. The file is named by a hash of the module bitcode
+ * and of the options the CFG depends on, so an unchanged program checked with the same
+ * bound, mode and function is loaded instead of rebuilt. It holds the states, transitions,
+ * constraints, variables, targets and main inputs in one flat little-endian record;
+ * the variables of the constraints are pooled ahead of the graph and referred to by index,
+ * and the constraints of every node are a length-prefixed block, so a lazy load keeps the
+ * blocks in memory and decodes one only when the search first reaches its node. */
+class CFGCache{
+    string fileName;
+    vector<char> buf;
+    size_t pos;
+    bool bad;
+    vector<Variable*> pool;
+    unordered_map<const Variable*, uint32_t> poolIndex;
+    vector<size_t> blocks;      //offset of the constraint block of every node when loaded lazily
+
+    void collect(const Variable *v);
+    void collect(const vector<Constraint> &consList);
+
+    void putBytes(const void *p, size_t n);
+    void putU32(uint32_t v){ putBytes(&v, sizeof(v)); }
+    void putI32(int32_t v){ putBytes(&v, sizeof(v)); }
+    void putString(const string &s);
+    void putVariable(const Variable *v);
+    void putPara(const ParaVariable &pv);
+    void putConstraints(const vector<Constraint> &consList);
+    void putInts(const vector<int> &v);
+
+    bool getBytes(void *p, size_t n);
+    uint32_t getU32();
+    int32_t getI32();
+    string getString();
+    Variable *getVariable(CFG *cfg);
+    void getPara(CFG *cfg, ParaVariable &pv);
+    void getConstraints(CFG *cfg, vector<Constraint> &consList);
+    void getInts(vector<int> &v);
+    void getBlock(CFG *cfg, vector<Constraint> &consList, int node, bool lazy);
+public:
+    CFGCache(string dir, const Module &M, string options);
+    string path(){return fileName;}
+    //false if there is no valid entry, cfg is then partially filled and must be dropped.
+    //A lazy load leaves the constraint lists empty, cfg takes over the cache to fill them
+    bool load(CFG *cfg, vector<int> &target, DebugInfo *dbg, bool lazy=false);
+    bool save(CFG *cfg, vector<int> &target, DebugInfo *dbg);
+    //decode the constraints of node ID into cfg, called once per node under the lock of cfg
+    void materialize(CFG *cfg, int ID);
+};
+
+#endif
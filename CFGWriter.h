@@ -204,7 +204,7 @@ public:
     for(unsigned int i=0;i<cfg->stateList.size();i++)
     for (node_iterator I = G->nodes->begin(), E = G->nodes->end() ;
          I != E; ++I) 
-        if(I->second.id == cfg->stateList[i].ID)
+        if(I->second.id == cfg->stateList[i]->ID)
         //writeNode(I->second);
         writeNode1(I->second,cfg);
   }
@@ -292,7 +292,7 @@ public:
       if (DTraits.hasNodeAddressLabel(Node, G))
         O << "|" << (void*)Node;
     }
-    O<<"\n"<<"\t"<<cfg->stateList[SN++].ContentRec;//cfg->ContentRec;
+    O<<"\n"<<"\t"<<cfg->stateList[SN++]->ContentRec;//cfg->ContentRec;
     std::string edgeSourceLabels;
     raw_string_ostream EdgeSourceLabels(edgeSourceLabels);
     bool hasEdgeSourceLabels = getEdgeSourceLabels(EdgeSourceLabels, Node);
@@ -0,0 +1,173 @@
+#include "IISStore.h"
+using namespace std;
+
+static const char IIS_MAGIC[8] = {'B','R','I','C','K','I','I','S'};
+static const uint32_t IIS_VERSION = 1;
+
+/* FNV-1a */
+static void hashBytes(uint64_t &h, const void *data, size_t len){
+    const unsigned char *p = (const unsigned char *)data;
+    for(size_t i=0;i<len;i++){
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+}
+
+static void hashString(uint64_t &h, const string &s){
+    uint32_t len = s.size();
+    hashBytes(h, &len, sizeof(len));
+    hashBytes(h, s.data(), s.size());
+}
+
+static void hashInt(uint64_t &h, int64_t v){
+    hashBytes(h, &v, sizeof(v));
+}
+
+static void hashVariable(uint64_t &h, Variable *v){
+    if(v==NULL){
+        hashInt(h, -1);
+        return;
+    }
+    hashString(h, v->name);
+    hashInt(h, v->type);
+    hashInt(h, v->numbits);
+}
+
+static void hashPara(uint64_t &h, ParaVariable &pv){
+    hashInt(h, pv.isExp);
+    hashInt(h, pv.op);
+    hashVariable(h, pv.lvar);
+    hashVariable(h, pv.rvar);
+    hashInt(h, pv.varList.size());
+    for(unsigned i=0;i<pv.varList.size();i++)
+        hashVariable(h, pv.varList[i]);
+}
+
+static void hashConstraints(uint64_t &h, vector<Constraint> &consList){
+    hashInt(h, consList.size());
+    for(unsigned i=0;i<consList.size();i++){
+        hashInt(h, consList[i].op);
+        hashPara(h, consList[i].lpvList);
+        hashPara(h, consList[i].rpvList);
+    }
+}
+
+static uint64_t hashState(State *st){
+    uint64_t h = 14695981039346656037ULL;
+    hashInt(h, 'S');
+    hashString(h, symbolTable.str(st->funcName));
+    hashInt(h, st->error);
+    hashInt(h, st->locList.size());
+    for(unsigned i=0;i<st->locList.size();i++)
+        hashInt(h, st->locList[i]);
+    hashConstraints(h, st->consList);
+    return h;
+}
+
+IISStore::IISStore(string file, CFG *cfg){
+    fileName = file;
+    out = NULL;
+    hashCFG(cfg);
+    if(!load()){
+        out = fopen(fileName.c_str(), "wb");
+        if(out){
+            fwrite(IIS_MAGIC, 1, sizeof(IIS_MAGIC), out);
+            fwrite(&IIS_VERSION, sizeof(IIS_VERSION), 1, out);
+        }
+    }
+    else
+        out = fopen(fileName.c_str(), "ab");
+    if(out==NULL)
+        errs()<<"IISStore: can not write "<<fileName<<"\n";
+    errs()<<"#IIS store:\t"<<fileName<<"\t"<<known.size()<<" segments\n";
+}
+
+IISStore::~IISStore(){
+    if(out)
+        fclose(out);
+    out = NULL;
+}
+
+/* content hash of every state and transition, unique hashes are indexed */
+void IISStore::hashCFG(CFG *cfg){
+    cfg->materializeAll();
+    unsigned total = cfg->stateList.size()+cfg->transitionList.size();
+    nodeHash.assign(total, 0);
+    map<uint64_t, int> count;
+    for(unsigned i=0;i<cfg->stateList.size();i++){
+        State *st = cfg->stateList[i];
+        nodeHash[st->ID] = hashState(st);
+    }
+    for(unsigned i=0;i<cfg->transitionList.size();i++){
+        Transition *tr = cfg->transitionList[i];
+        uint64_t h = 14695981039346656037ULL;
+        hashInt(h, 'T');
+        hashInt(h, tr->fromState?nodeHash[tr->fromState->ID]:0);
+        hashInt(h, tr->toState?nodeHash[tr->toState->ID]:0);
+        hashConstraints(h, tr->guardList);
+        nodeHash[tr->ID] = h;
+    }
+    for(unsigned i=0;i<total;i++){
+        count[nodeHash[i]]++;
+        nodeID[nodeHash[i]] = i;
+    }
+    //ambiguous nodes can not be resolved
+    for(map<uint64_t, int>::iterator it=count.begin();it!=count.end();++it){
+        if(it->second>1)
+            nodeID[it->first] = -1;
+    }
+}
+
+bool IISStore::load(){
+    FILE *in = fopen(fileName.c_str(), "rb");
+    if(in==NULL)
+        return false;
+    char magic[8];
+    uint32_t version = 0;
+    if(fread(magic, 1, sizeof(magic), in)!=sizeof(magic)||memcmp(magic, IIS_MAGIC, sizeof(magic))!=0||
+       fread(&version, sizeof(version), 1, in)!=1||version!=IIS_VERSION){
+        errs()<<"IISStore: "<<fileName<<" is not a valid store, recreate it\n";
+        fclose(in);
+        return false;
+    }
+    uint32_t n;
+    while(fread(&n, sizeof(n), 1, in)==1){
+        vector<uint64_t> record(n);
+        if(n==0||fread(&record[0], sizeof(uint64_t), n, in)!=n)
+            break;
+        if(known.insert(record).second)
+            loaded.push_back(record);
+    }
+    fclose(in);
+    return true;
+}
+
+vector<vector<int> > IISStore::getSegments(){
+    lock_guard<mutex> guard(lock);
+    vector<vector<int> > segments;
+    for(unsigned i=0;i<loaded.size();i++){
+        vector<int> segment;
+        for(unsigned j=0;j<loaded[i].size();j++){
+            map<uint64_t, int>::iterator it = nodeID.find(loaded[i][j]);
+            if(it==nodeID.end()||it->second<0)
+                break;
+            segment.push_back(it->second);
+        }
+        if(segment.size()==loaded[i].size())
+            segments.push_back(segment);
+    }
+    return segments;
+}
+
+void IISStore::add(vector<int> &segment){
+    vector<uint64_t> record;
+    for(unsigned i=0;i<segment.size();i++)
+        record.push_back(nodeHash[segment[i]]);
+    lock_guard<mutex> guard(lock);
+    if(!known.insert(record).second||out==NULL)
+        return;
+    uint32_t n = record.size();
+    fwrite(&n, sizeof(n), 1, out);
+    fwrite(&record[0], sizeof(uint64_t), n, out);
+    fflush(out);
+}
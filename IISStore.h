@@ -0,0 +1,36 @@
+#ifndef _iisstore_h
+#define _iisstore_h
+#include "CFG.h"
+#include <stdint.h>
+#include <set>
+#include <mutex>
+#include <cstdio>
+#include <cstring>
+
+/* On-disk store of infeasible path segments (IIS) shared across runs.
+ * A segment is kept as the sequence of content hashes of its states and transitions
+ * (function, source lines and constraints), not their IDs, so it survives the
+ * renumbering caused by another bound or by edits elsewhere in the program.
+ * Records are appended to the file as soon as they are found. */
+class IISStore{
+    string fileName;
+    FILE *out;
+    mutex lock;
+    set<vector<uint64_t> > known;
+    vector<vector<uint64_t> > loaded;
+    map<uint64_t, int> nodeID;
+    vector<uint64_t> nodeHash;
+
+    void hashCFG(CFG *cfg);
+    bool load();
+public:
+    IISStore(string file, CFG *cfg);
+    ~IISStore();
+    //segments of the store which exist in the current CFG
+    vector<vector<int> > getSegments();
+    //record a new infeasible segment: state, transition, state, ...
+    void add(vector<int> &segment);
+    unsigned size(){return known.size();}
+};
+
+#endif
@@ -2090,66 +2090,25 @@ bool InstParser::InsertCFGLabel(CFG* cfg,const BasicBlock *BB, State* s, string
         string SLot = BB->getName();
         //stringstream ss;
         lname = func+"."+SLot; 
-        cfg->LabelMap.insert( pair<string,State*> (lname,s));
-        cfg->endBlock[lname] = lname;
+        Symbol label = symbolTable.intern(lname);
+        cfg->LabelMap.insert( pair<Symbol,State*> (label,s));
+        cfg->endBlock[label] = label;
         //    errs()<<"func\t"<<lname <<"\t"<< s->name<<"~~~~~~~~~~~~~~~\n";
-
-        for(unsigned int i=0;i<cfg->transitionList.size();i++){
-                if(cfg->transitionList[i].toLabel == lname&&cfg->transitionList[i].toState==NULL)
-                {                   
-                    cfg->transitionList[i].toName = s->name;
-                    cfg->transitionList[i].toState = s;
-                    s->level = cfg->transitionList[i].level;
-                    hasFromS = true;
-                };
-        }   
-        for(unsigned int i=0;i<cfg->stateList.size();i++)
-        {
-            State s1= cfg->stateList[i];
-            for(unsigned int j=0;j<s1.transList.size();j++)
-            {
-                if(s1.transList[j]->toLabel == lname && s1.transList[j]->toState == NULL)
-                {
-                    s1.transList[j]->toName = s->name;
-                    s1.transList[j]->toState = s;
-                    s->level = s1.transList[j]->level;
-                }
-            }
-        }
     }
     else{
         if(!BB->hasName()){
             errs()<<"1.InsertCFGLabel:error 10086!!!: "<<*BB<<"\n";    
         }
         lname = name; 
-        cfg->LabelMap.insert( pair<string,State*> (lname,s));
+        Symbol label = symbolTable.intern(lname);
+        cfg->LabelMap.insert( pair<Symbol,State*> (label,s));
         string SLot = BB->getName();
         string lname_origin = func+"."+SLot; 
-        cfg->endBlock[lname_origin] = lname;
-
-        for(unsigned int i=0;i<cfg->transitionList.size();i++){
-                if(cfg->transitionList[i].toLabel == lname&&cfg->transitionList[i].toState==NULL)
-                {                   
-                    cfg->transitionList[i].toName = s->name;
-                    cfg->transitionList[i].toState = s;
-                    s->level = cfg->transitionList[i].level;
-                    hasFromS = true;
-                };
-        }   
-        for(unsigned int i=0;i<cfg->stateList.size();i++)
-        {
-            State s1= cfg->stateList[i];
-            for(unsigned int j=0;j<s1.transList.size();j++)
-            {
-                if(s1.transList[j]->toLabel == lname && s1.transList[j]->toState == NULL)
-                {
-                    s1.transList[j]->toName = s->name;
-                    s1.transList[j]->toState = s;
-                    s->level = s1.transList[j]->level;
-                }
-            }
-        }
+        cfg->endBlock[symbolTable.intern(lname_origin)] = label;
     }
+    //patch the forward references to this label
+    if(cfg->resolveLabel(lname, s))
+        hasFromS = true;
 //    errs()<<"InsertCFGLabel: "<<lname<<"\t"<<*s<<"\n";
     return hasFromS;
 }
@@ -2771,6 +2730,26 @@ unsigned getNumBits(const Value *V){
     return VTy->getPrimitiveSizeInBits();
 }
 
+//variable of argument A of func, created by the first call when the body of func is shared
+static Variable *argVariable(CFG *cfg, const Argument *A, string func){
+    string varNum = A->getName();
+    string varName = func+"."+varNum;
+    if(!cfg->hasVariable(varName)){
+        Type *Ty = A->getType();
+        VarType type = FP;
+        unsigned numBits = getNumBits(A);
+        if(Ty->isPointerTy()){
+            type = PTR;
+            numBits = 0;
+        }
+        else if(Ty->isIntegerTy())
+            type = INT;
+        Variable var(varName, cfg->counter_variable++, type, numBits);
+        cfg->variableList.push_back(var);
+    }
+    return cfg->getVariable(varName);
+}
+
 void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, string func, int bound, DebugInfo *dbg){
     const Instruction* I = dyn_cast<Instruction>(it);
     string op = I->getOpcodeName();
@@ -2788,7 +2767,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             string varName = func+"."+varNum;
             if(cfg->hasVariable(varName)){
                 Variable *var = cfg->getVariable(varName);
-                p1.rvar = new Variable(var);
+                p1.rvar = cfg->terms.var(var);
                 p1.isExp=false;
             }
             else
@@ -2867,7 +2846,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
         else{
             Variable var(c, cfg->counter_variable++, INT, numBits);
             cfg->variableList.push_back(var);
-            p1.rvar = new Variable(var);
+            p1.rvar = cfg->terms.var(var);
             p1.isExp=false;
             cTemp.lpvList = p1;
         }
@@ -2881,22 +2860,22 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             string varName = func+"."+varNum;
             if(j==0){
                 if(isConstantVal(v1)){                                      
-                    pTemp1.rvar = new Variable(varNum,-1,FPNUM,numBits);
+                    pTemp1.rvar = cfg->terms.var(varNum,-1,FPNUM,numBits);
                     pTemp1.isExp=false;
-                    p2.lvar = new Variable(varNum,-1,FPNUM,numBits);
+                    p2.lvar = cfg->terms.var(varNum,-1,FPNUM,numBits);
                 }
                 else if(isa<ConstantPointerNull>(v1)){                                  
-                    pTemp1.rvar = new Variable("0",-1,PTR,0);
+                    pTemp1.rvar = cfg->terms.var("0",-1,PTR,0);
                     pTemp1.isExp=false;                            
-                    p2.lvar = new Variable("0",-1,PTR,0);
+                    p2.lvar = cfg->terms.var("0",-1,PTR,0);
                 }
                 else if(cfg->hasVariable(varName)){
                     Variable *var = cfg->getVariable(varName);
                     if(var->type!=FP)
                         errs()<<"0.FCMP error 10086: "<<varName<<"is a PTR\n";
-                    pTemp1.rvar = new Variable(var);
+                    pTemp1.rvar = cfg->terms.var(var);
                     pTemp1.isExp=false;
-                    p2.lvar = new Variable(var);
+                    p2.lvar = cfg->terms.var(var);
                 }
                 else
                     errs()<<"1.FCMP error 10086: "<<*v1<<"\n";
@@ -2905,22 +2884,22 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             }
             else if(j==1){   
                 if(isConstantVal(v1)){          
-                    pTemp2.rvar = new Variable(varNum,-1,FPNUM,numBits);
+                    pTemp2.rvar = cfg->terms.var(varNum,-1,FPNUM,numBits);
                     pTemp2.isExp=false;
-                    p2.rvar = new Variable(varNum,-1,FPNUM,numBits);
+                    p2.rvar = cfg->terms.var(varNum,-1,FPNUM,numBits);
                 }     
                 else if(isa<ConstantPointerNull>(v1)){                                  
-                    pTemp2.rvar = new Variable("0",-1,PTR,0);
+                    pTemp2.rvar = cfg->terms.var("0",-1,PTR,0);
                     pTemp2.isExp=false;
-                    p2.rvar = new Variable("0",-1,PTR,0);
+                    p2.rvar = cfg->terms.var("0",-1,PTR,0);
                 }
                 else if(cfg->hasVariable(varName)){
                     Variable *var = cfg->getVariable(varName);
                     if(var->type!=FP)
                         errs()<<"2.FCMP error 10086: "<<varName<<"is not a FP\n";
-                    pTemp2.rvar = new Variable(var);
+                    pTemp2.rvar = cfg->terms.var(var);
                     pTemp2.isExp=false;
-                    p2.rvar = new Variable(var);
+                    p2.rvar = cfg->terms.var(var);
                 } 
                 else
                     errs()<<"3.FCMP error 10086: "<<varName<<"\n";
@@ -2952,7 +2931,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
         else{
             Variable var(c, cfg->counter_variable++, INT, numBits);
             cfg->variableList.push_back(var);
-            pt1.rvar = new Variable(var);
+            pt1.rvar = cfg->terms.var(var);
             pt1.isExp=false;
             cTemp.lpvList = pt1;
         }
@@ -2966,14 +2945,14 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             string varName = func+"."+varNum;
             if(j==0){
                 if(isConstantVal(v1)){                                      
-                    pTemp1.rvar = new Variable(varNum,-1,INTNUM,numBits);
+                    pTemp1.rvar = cfg->terms.var(varNum,-1,INTNUM,numBits);
                     pTemp1.isExp=false;
-                    pt2.lvar = new Variable(varNum,-1,INTNUM,numBits);
+                    pt2.lvar = cfg->terms.var(varNum,-1,INTNUM,numBits);
                 }
                 else if(isa<ConstantPointerNull>(v1)){                                  
-                    pTemp1.rvar = new Variable("0",-1,PTR,0);
+                    pTemp1.rvar = cfg->terms.var("0",-1,PTR,0);
                     pTemp1.isExp=false;
-                    pt2.lvar = new Variable("0",-1,PTR,0);
+                    pt2.lvar = cfg->terms.var("0",-1,PTR,0);
                 }
                 else if(isa<ConstantExpr>(v1)){
                     ConstantExpr *expr = dyn_cast<ConstantExpr>(v1);
@@ -2997,7 +2976,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                             Variable *var = cfg->getVariable(varName1);
                             if(var->type!=PTR)
                                 errs()<<"2.Icmp: error 10086: "<<varName<<"\n";
-                            p2.varList.push_back(new Variable(var));
+                            p2.varList.push_back(cfg->terms.var(var));
                         }
                         else
                             errs()<<"3.Icmp.Getelementptr: error 10086\t"<<varName1<<"\n";        
@@ -3005,7 +2984,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                         string tempName = varName+".t"+intToString(j);
                         Variable tVar(tempName, cfg->counter_variable++, PTR, 0);
                         cfg->variableList.push_back(tVar);
-                        p1.rvar = new Variable(tVar);
+                        p1.rvar = cfg->terms.var(tVar);
                         p2.op = GETPTR;
                         p2.isExp = true;
 
@@ -3015,7 +2994,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                             numBits = getNumBits(v2);
                             varNum1 = getVariableName(Out, v2, &TypePrinter, &Machine, TheModule);
                             if(isConstantVal(v2))
-                                p2.varList.push_back(new Variable(varNum1,-1,INTNUM,numBits));
+                                p2.varList.push_back(cfg->terms.var(varNum1,-1,INTNUM,numBits));
                             else 
                                 errs()<<"4.Icmp: error 10086: "<<varNum1<<"\n";        
                         }
@@ -3023,17 +3002,17 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                         cTemp1.lpvList = p1;
                         cTemp1.rpvList = p2;
                         s->consList.push_back(cTemp1);    
-                        pTemp1.rvar = new Variable(tVar);
-                        pt2.lvar = new Variable(tVar);
+                        pTemp1.rvar = cfg->terms.var(tVar);
+                        pt2.lvar = cfg->terms.var(tVar);
                     }
                 }
                 else if(cfg->hasVariable(varName)){
                     Variable *var = cfg->getVariable(varName);
                     if(var->type!=INT&&var->type!=PTR)
                         errs()<<"5.ICMP warning 10086: "<<varName<<"is not a INT or PTR\n";
-                    pTemp1.rvar = new Variable(var);
+                    pTemp1.rvar = cfg->terms.var(var);
                     pTemp1.isExp=false;
-                    pt2.lvar = new Variable(var);
+                    pt2.lvar = cfg->terms.var(var);
                 }
                 else 
                     errs()<<"6.ICMP error 10086: "<<*v1<<"\n";
@@ -3042,14 +3021,14 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             }
             else if(j==1){         
                 if(isConstantVal(v1)){         
-                    pTemp2.rvar = new Variable(varNum,-1,INTNUM,numBits);
+                    pTemp2.rvar = cfg->terms.var(varNum,-1,INTNUM,numBits);
                     pTemp2.isExp=false;
-                    pt2.rvar = new Variable(varNum,-1,INTNUM,numBits);
+                    pt2.rvar = cfg->terms.var(varNum,-1,INTNUM,numBits);
                 }
                 else if(isa<ConstantPointerNull>(v1)){                                  
-                    pTemp2.rvar = new Variable("0",-1,PTR,0);
+                    pTemp2.rvar = cfg->terms.var("0",-1,PTR,0);
                     pTemp2.isExp=false;
-                    pt2.rvar = new Variable("0",-1,PTR,0);
+                    pt2.rvar = cfg->terms.var("0",-1,PTR,0);
                 }
                 else if(isa<ConstantExpr>(v1)){
                     ConstantExpr *expr = dyn_cast<ConstantExpr>(v1);
@@ -3073,7 +3052,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                             Variable *var = cfg->getVariable(varName1);
                             if(var->type!=PTR)
                                 errs()<<"8.Icmp: error 10086: "<<varName<<"\n";
-                            p2.varList.push_back(new Variable(varName1,var->ID,PTR,0));
+                            p2.varList.push_back(cfg->terms.var(varName1,var->ID,PTR,0));
                         }
                         else
                             errs()<<"9.Icmp.Getelementptr: error 10086\t"<<varName1<<"\n";      
@@ -3081,7 +3060,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                         string tempName = varName+".t"+intToString(j);
                         Variable tVar(tempName, cfg->counter_variable++, PTR,0);
                         cfg->variableList.push_back(tVar);
-                        p1.rvar = new Variable(tVar);
+                        p1.rvar = cfg->terms.var(tVar);
                         p2.op = GETPTR;
                         p2.isExp = true;
 
@@ -3091,7 +3070,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                             numBits = getNumBits(v2);
                             varNum1 = getVariableName(Out, v2, &TypePrinter, &Machine, TheModule);
                             if(isConstantVal(v2))
-                                p2.varList.push_back(new Variable(varNum1,-1,INTNUM,numBits));
+                                p2.varList.push_back(cfg->terms.var(varNum1,-1,INTNUM,numBits));
                             else 
                                 errs()<<"10.Icmp: error 10086: "<<varNum1<<"\n";     
                         }
@@ -3099,17 +3078,17 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                         cTemp1.lpvList = p1;
                         cTemp1.rpvList = p2;
                         s->consList.push_back(cTemp1);  
-                        pTemp2.rvar = new Variable(tVar);
-                        pt2.rvar = new Variable(tVar);
+                        pTemp2.rvar = cfg->terms.var(tVar);
+                        pt2.rvar = cfg->terms.var(tVar);
                     }
                 }
                 else if(cfg->hasVariable(varName)){
                     Variable *var = cfg->getVariable(varName);
                     if(var->type!=INT&&var->type!=PTR)
                         errs()<<"11.ICMP warning 10086: "<<varName<<"is not a INT or PTR\n";
-                    pTemp2.rvar = new Variable(var);
+                    pTemp2.rvar = cfg->terms.var(var);
                     pTemp2.isExp=false;
-                    pt2.rvar = new Variable(var);
+                    pt2.rvar = cfg->terms.var(var);
                 }
                 else 
                     errs()<<"12.ICMP error 10086: "<<*v1<<"\n";
@@ -3151,7 +3130,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
         else{
             Variable var(c, cfg->counter_variable++, type, numBits);
             cfg->variableList.push_back(var);
-            pTemp1.rvar = new Variable(var);
+            pTemp1.rvar = cfg->terms.var(var);
             pTemp1.isExp=false;
         }
         cTemp.lpvList = pTemp1;
@@ -3166,7 +3145,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                     Variable *var = cfg->getVariable(varName);
                     if(var->type!=INT && var->type!=FP && pvop!=BITCAST)
                         assert(false && "type is PTR and op is not bitcast!!!");
-                    pTemp2.rvar = new Variable(var);
+                    pTemp2.rvar = cfg->terms.var(var);
                     pTemp2.isExp=true;
                 }
                 else{
@@ -3210,7 +3189,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
         else{
             Variable var(c, cfg->counter_variable++, type, numBits);
             cfg->variableList.push_back(var);
-            pTemp1.rvar = new Variable(var);
+            pTemp1.rvar = cfg->terms.var(var);
             pTemp1.isExp=false;
         }
             for(unsigned j = 0;j< n1; j ++){
@@ -3238,7 +3217,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                             Variable *var = cfg->getVariable(varName);
                             if(var->type!=PTR)
                                 errs()<<"5.Load: error 10086: "<<varName<<"\n";
-                            p2.varList.push_back(new Variable(varName,var->ID,PTR,0));
+                            p2.varList.push_back(cfg->terms.var(varName,var->ID,PTR,0));
                         }
                         else
                             errs()<<"6.Load:Getelementptr: error 10086\t"<<varName<<"\n";      
@@ -3246,7 +3225,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                         string tempName = varName+".t"+intToString(j);
                         Variable tVar(tempName, cfg->counter_variable++, PTR, 0);
                         cfg->variableList.push_back(tVar);
-                        p1.rvar = new Variable(tVar);
+                        p1.rvar = cfg->terms.var(tVar);
                         p2.op = GETPTR;
                         p2.isExp = true;
 
@@ -3256,7 +3235,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                             numBits = getNumBits(v2);
                             varNum = getVariableName(Out, v2, &TypePrinter, &Machine, TheModule);
                             if(isConstantVal(v2))
-                                p2.varList.push_back(new Variable(varNum,-1,INTNUM,numBits));
+                                p2.varList.push_back(cfg->terms.var(varNum,-1,INTNUM,numBits));
                             else 
                                 errs()<<"7.Load:error 10086: "<<varNum<<"\n";     
                         }
@@ -3264,7 +3243,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                         cTemp1.lpvList = p1;
                         cTemp1.rpvList = p2;
                         s->consList.push_back(cTemp1);  
-                        pTemp2.rvar = new Variable(tVar);
+                        pTemp2.rvar = cfg->terms.var(tVar);
                     }
                 }
                 else if(isa<GlobalVariable>(v1)){
@@ -3273,7 +3252,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                         varName = setGlobal(varName, v1, cfg, s);
                     }
                     Variable *var = cfg->getVariable(varName);
-                    pTemp2.rvar = new Variable(var);
+                    pTemp2.rvar = cfg->terms.var(var);
                 }
                 else{
                     string varNum = getVariableName(Out, v1, &TypePrinter, &Machine, TheModule);
@@ -3283,7 +3262,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                             Variable *var = cfg->getVariable(varName);
                             if(var->type!=PTR)
                                 errs()<<"9.Load: error 10086: "<<varName<<"\n";
-                            pTemp2.rvar = new Variable(varName,var->ID,PTR,0);
+                            pTemp2.rvar = cfg->terms.var(varName,var->ID,PTR,0);
                         }
                         else{
                             errs()<<"10.load:Error 10086!! "<<*I<<"\t"<<varName<<"\t"<<"\n";
@@ -3347,7 +3326,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                     Variable *var = cfg->getVariable(varName1);
                     if(var->type!=PTR)
                         errs()<<"2.Store error 10086: "<<varName<<"\n";
-                    p2.varList.push_back(new Variable(varName1,var->ID,PTR,0));
+                    p2.varList.push_back(cfg->terms.var(varName1,var->ID,PTR,0));
                 }
                 else
                     errs()<<"3.Store Getelementptr: error 10086\t"<<varName1<<"\n";      
@@ -3355,7 +3334,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                 string tempName = varName+".t";
                 Variable tVar(tempName, cfg->counter_variable++, PTR, 0);
                 cfg->variableList.push_back(tVar);
-                p1.rvar = new Variable(tVar);                        
+                p1.rvar = cfg->terms.var(tVar);                        
                 p2.op = GETPTR;
                 p2.isExp = true;
 
@@ -3365,7 +3344,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                     numBits = getNumBits(v2);
                     varNum1 = getVariableName(Out, v2, &TypePrinter, &Machine, TheModule);
                     if(isConstantVal(v2))                            
-                        p2.varList.push_back(new Variable(varNum1,-1,INTNUM,numBits));
+                        p2.varList.push_back(cfg->terms.var(varNum1,-1,INTNUM,numBits));
                     else 
                         errs()<<"4.Store error 10086: "<<varNum1<<"\n";     
                 }
@@ -3373,7 +3352,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                 cTemp1.lpvList = p1;
                 cTemp1.rpvList = p2;
                 s->consList.push_back(cTemp1);  
-                pTemp2.rvar = new Variable(tVar);
+                pTemp2.rvar = cfg->terms.var(tVar);
             }
         }
         else if(isa<GlobalVariable>(v1)){
@@ -3382,7 +3361,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                  varName_1 = setGlobal(varName_1, v1, cfg, s);
             }
             Variable *var = cfg->getVariable(varName_1);
-            pTemp2.rvar = new Variable(var);
+            pTemp2.rvar = cfg->terms.var(var);
         }
         else if(isConstantVal(v1)){
             string varName_1 = varName2+"/"+intToString(Line);
@@ -3394,31 +3373,31 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             else{
                 type = FP;type1 = FPNUM;
             }
-            Variable var = new Variable(varName_1,cfg->counter_variable++,type,numBits);
+            Variable var = cfg->terms.var(varName_1,cfg->counter_variable++,type,numBits);
             cfg->variableList.push_back(var);
-            pTemp1.rvar = new Variable(var); 
-            pTemp2.rvar = new Variable(varNum,-1,type1,numBits);
+            pTemp1.rvar = cfg->terms.var(var); 
+            pTemp2.rvar = cfg->terms.var(varNum,-1,type1,numBits);
             pTemp2.isExp = false;
             cTemp.lpvList = pTemp1;
             cTemp.rpvList = pTemp2;
             s->consList.push_back(cTemp);
-            pTemp2.rvar = new Variable(var);
+            pTemp2.rvar = cfg->terms.var(var);
         }
         else if(isa<ConstantPointerNull>(v1)){                                  
             string varName_1 = varName2+"/"+intToString(Line);
             numBits = getNumBits(v1);
-            Variable var = new Variable(varName_1,cfg->counter_variable++,PTR,0);
+            Variable var = cfg->terms.var(varName_1,cfg->counter_variable++,PTR,0);
             cfg->variableList.push_back(var);
-            pTemp1.rvar = new Variable(var); 
-            pTemp2.rvar = new Variable("0",-1,PTR,0);
+            pTemp1.rvar = cfg->terms.var(var); 
+            pTemp2.rvar = cfg->terms.var("0",-1,PTR,0);
             cTemp.lpvList = pTemp1;
             cTemp.rpvList = pTemp2;
             s->consList.push_back(cTemp);
-            pTemp2.rvar = new Variable(var);
+            pTemp2.rvar = cfg->terms.var(var);
             }
         else if(cfg->hasVariable(varName)){
             Variable *var = cfg->getVariable(varName);
-            pTemp2.rvar = new Variable(var);
+            pTemp2.rvar = cfg->terms.var(var);
         }
         else{
             errs()<<"6.Store error 10086\t"<<varName<<"\t"<<*I<<"\n";
@@ -3432,13 +3411,13 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                  varName2 = setGlobal(varName2, v2, cfg, s);
             }
             Variable *var = cfg->getVariable(varName2);
-            pTemp1.rvar = new Variable(var);
+            pTemp1.rvar = cfg->terms.var(var);
         }
         else if(cfg->hasVariable(varName2)){
             Variable *var = cfg->getVariable(varName2);
             if(var->type!=PTR)
                 errs()<<"9.Store error 10086\t"<<varName2<<"\n";
-            pTemp1.rvar = new Variable(var);
+            pTemp1.rvar = cfg->terms.var(var);
         }
         else
             errs()<<"10.Store error 10086\t"<<varName2<<"\t"<<*I<<"\n";
@@ -3478,7 +3457,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
         else{
             Variable var(c, cfg->counter_variable++, type, numBits);
             cfg->variableList.push_back(var);
-            pTemp1.rvar = new Variable(var);
+            pTemp1.rvar = cfg->terms.var(var);
             pTemp1.isExp=false;
         }
         cTemp.lpvList = pTemp1;
@@ -3490,32 +3469,32 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             string varName = func+"."+varNum;
             if(j==0){
                 if(isa<ConstantInt>(v1)){
-	                pTemp2.lvar = new Variable(varNum,-1,INTNUM,numBits);
+	                pTemp2.lvar = cfg->terms.var(varNum,-1,INTNUM,numBits);
 	            }
 	            else if(isa<ConstantFP>(v1)){
-	                pTemp2.lvar = new Variable(varNum,-1,FPNUM,numBits);
+	                pTemp2.lvar = cfg->terms.var(varNum,-1,FPNUM,numBits);
 	            } 
                 else if(cfg->hasVariable(varName)){
                     Variable *var = cfg->getVariable(varName);
                     if(var->type!=INT && var->type!=FP)
                         errs()<<"1.Compute: error 10086: "<<varName<<"\n";
-                    pTemp2.lvar = new Variable(var);
+                    pTemp2.lvar = cfg->terms.var(var);
                 }
                 else 
                     errs()<<"2.Compute: error 10086: "<<varName<<"\n";
             }        
             else if(j==1){        
                 if(isa<ConstantInt>(v1)){
-                    pTemp2.rvar = new Variable(varNum,-1,INTNUM,numBits);
+                    pTemp2.rvar = cfg->terms.var(varNum,-1,INTNUM,numBits);
                 }
                 else if(isa<ConstantFP>(v1)){
-	                pTemp2.rvar = new Variable(varNum,-1,FPNUM,numBits);
+	                pTemp2.rvar = cfg->terms.var(varNum,-1,FPNUM,numBits);
 	            } 
                 else if(cfg->hasVariable(varName)){
                     Variable *var = cfg->getVariable(varName);
                     if(var->type!=INT && var->type!=FP)
                         errs()<<"3.Compute: error 10086: "<<varName<<"\n";
-                    pTemp2.rvar = new Variable(var);
+                    pTemp2.rvar = cfg->terms.var(var);
                 }        
                 else 
                     errs()<<"4.Compute: error 10086: "<<varName<<"\n";
@@ -3567,7 +3546,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
         else{
             Variable var(c, cfg->counter_variable++, type, numBits);
             cfg->variableList.push_back(var);
-            pTemp1.rvar = new Variable(var);
+            pTemp1.rvar = cfg->terms.var(var);
             pTemp1.isExp=false;
         }
         cTemp.op = ASSIGN;
@@ -3588,8 +3567,8 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
         st1>>tt1;
         st2<<t2;
         st2>>tt2;
-        tr1=new Transition(t1,"e"+tt1);
-        tr2=new Transition(t2,"e"+tt2);
+        tr1=cfg->arena.make<Transition>(t1,"e"+tt1);
+        tr2=cfg->arena.make<Transition>(t2,"e"+tt2);
         tr1->fromState=s;
            tr1->fromName=s->name;
            tr1->level=s->level+1;
@@ -3600,7 +3579,6 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
            tr2->level=s->level+1;
         tr2->toState=NULL;
 
-        cfg->stateList.push_back(*s);
         State *s1;
         State *s2;
         BasicBlock* b = it->getParent();
@@ -3618,14 +3596,14 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             if(j==1){//its the left
 
                 if(isa<ConstantInt>(v1)){
-                    pTemp2.rvar = new Variable(varNum,-1,INTNUM,numBits);
+                    pTemp2.rvar = cfg->terms.var(varNum,-1,INTNUM,numBits);
                 }
                 else if(isa<ConstantFP>(v1)){
-	                pTemp2.rvar = new Variable(varNum,-1,FPNUM,numBits);
+	                pTemp2.rvar = cfg->terms.var(varNum,-1,FPNUM,numBits);
 	            } 
                 else if(cfg->hasVariable(varName)){
                     Variable *var = cfg->getVariable(varName);
-                    pTemp2.rvar = new Variable(var);
+                    pTemp2.rvar = cfg->terms.var(var);
                 }
                 else 
                     errs()<<"4.Select: error 10086: "<<varName<<"\n";
@@ -3635,10 +3613,10 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                 int id = cfg->counter_state++;
                 string  str = intToString(cfg->counter_s_state++);
                 string name = "s"+str;
-                s1 = new State(false, id, name, func);
+                s1 = cfg->arena.make<State>(false, id, name, func);
 
                 toLabel1=c+".true";
-                tr1->toLabel=toLabel1;
+                tr1->toLabel=symbolTable.intern(toLabel1);
                 InsertCFGLabel(cfg,b,s1, func, toLabel1, true);
 
                 if(s1!=NULL)
@@ -3649,21 +3627,20 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                 s1->level = tr1->level;
 
                 tr1->guardList.push_back(cfg->c_tmp1);
-                s->transList.push_back(tr1);
-                cfg->transitionList.push_back(*tr1);//follow the transList
+                cfg->addTransition(s, tr1);//follow the transList
 
                 s1->consList.push_back(cTemp);
             }
             else if (j==2){//right
                 if(isa<ConstantInt>(v1)){
-                    pTemp2.rvar = new Variable(varNum,-1,INTNUM,numBits);
+                    pTemp2.rvar = cfg->terms.var(varNum,-1,INTNUM,numBits);
                 }
                 else if(isa<ConstantFP>(v1)){
-	                pTemp2.rvar = new Variable(varNum,-1,FPNUM,numBits);
+	                pTemp2.rvar = cfg->terms.var(varNum,-1,FPNUM,numBits);
 	            } 
                 else if(cfg->hasVariable(varName)){
                     Variable *var = cfg->getVariable(varName);
-                    pTemp2.rvar = new Variable(var);
+                    pTemp2.rvar = cfg->terms.var(var);
                 }
                 else 
                     errs()<<"5.Select: error 10086: "<<varName<<"\n";
@@ -3673,11 +3650,11 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                 int id = cfg->counter_state++;
                 string  str = intToString(cfg->counter_s_state++);
                 string name = "s"+str;
-                s2 = new State(false, id, name, func);
+                s2 = cfg->arena.make<State>(false, id, name, func);
 //                errs()<<*s2<<"\n";
 
                 toLabel2=c+".false";
-                tr2->toLabel=toLabel2;
+                tr2->toLabel=symbolTable.intern(toLabel2);
                 InsertCFGLabel(cfg,b,s2, func, toLabel2, true);
                 if(s2!=NULL)
                 {
@@ -3687,8 +3664,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                 s2->level = tr2->level;
 
                 tr2->guardList.push_back(cfg->c_tmp2);
-                s->transList.push_back(tr2);
-                cfg->transitionList.push_back(*tr2);//follow the transList
+                cfg->addTransition(s, tr2);//follow the transList
 
                 s2->consList.push_back(cTemp);
             }
@@ -3697,7 +3673,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
         int id = cfg->counter_state++;
         string  str = intToString(cfg->counter_s_state++);
         string name = "s"+str;
-        State *s3 = new State(false, id, name, func);
+        State *s3 = cfg->arena.make<State>(false, id, name, func);
 
         Transition *tr3, *tr4;
         t1 =cfg->counter_transition++;
@@ -3706,8 +3682,8 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
         st1>>tt1;
         st2<<t2;
         st2>>tt2;
-        tr3=new Transition(t1,"e"+tt1);
-        tr4=new Transition(t2,"e"+tt2);
+        tr3=cfg->arena.make<Transition>(t1,"e"+tt1);
+        tr4=cfg->arena.make<Transition>(t2,"e"+tt2);
         tr3->fromState=s1;
            tr3->fromName=s1->name;
            tr3->level=s1->level+1;
@@ -3721,17 +3697,14 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
         s3->level = (tr3->level>tr4->level)?tr4->level:tr3->level;
         string toLabel3 = c+".ret";
 
-        tr3->toLabel=toLabel3;
-        tr4->toLabel=toLabel3;
-        s1->transList.push_back(tr3);
-        s2->transList.push_back(tr4);
-
-        cfg->transitionList.push_back(*tr3);
-        cfg->transitionList.push_back(*tr4);
+        tr3->toLabel=symbolTable.intern(toLabel3);
+        tr4->toLabel=symbolTable.intern(toLabel3);
+        cfg->addTransition(s1, tr3);
+        cfg->addTransition(s2, tr4);
         cfg->stateList.resize(id+1);
-        cfg->stateList[s->ID] = *s;
-        cfg->stateList[s1->ID] = *s1;
-        cfg->stateList[s2->ID] = *s2;
+        cfg->stateList[s->ID] = s;
+        cfg->stateList[s1->ID] = s1;
+        cfg->stateList[s2->ID] = s2;
 
         InsertCFGLabel(cfg,b,s3, func, toLabel3, true);
 
@@ -3763,7 +3736,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             Variable var(c, cfg->counter_variable++, type, numBits);
             cfg->variableList.push_back(var);
             cfg->exprList.push_back(var);
-            pTemp1.rvar = new Variable(var);
+            pTemp1.rvar = cfg->terms.var(var);
             pTemp1.isExp=false;
         }
 
@@ -3776,18 +3749,18 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             string varName = func+"."+varNum;
             if(isa<ConstantInt>(v)){
                 cTemp.op = EQ;
-                pTemp2.rvar = new Variable(varNum,-1,INTNUM,numBits);
+                pTemp2.rvar = cfg->terms.var(varNum,-1,INTNUM,numBits);
             }
             else if(isa<ConstantFP>(v)){
                 cTemp.op = EQ;
-	            pTemp2.rvar = new Variable(varNum,-1,FPNUM,numBits);
+	            pTemp2.rvar = cfg->terms.var(varNum,-1,FPNUM,numBits);
 	        } 
             else if(cfg->hasVariable(varName)){
                 cTemp.op = ASSIGN;
                 Variable *var = cfg->getVariable(varName);
                 if(var->type!=type)
                     errs()<<"2.PHINode error 10086: "<<varName<<"\n";
-                pTemp2.rvar = new Variable(var);
+                pTemp2.rvar = cfg->terms.var(var);
             }
             else{
                 errs()<<"3.PHINode warning 10086: "<<*I<<"\t"<<varName<<"\t"<<s->level<<"\n";
@@ -3801,22 +3774,15 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             BasicBlock *bb = PN->getIncomingBlock(i);
             string bbName = bb->getName();
             string fromLabel = func+"."+bbName;
-            string label = cfg->endBlock[fromLabel];
+            Symbol label = cfg->endBlock[symbolTable.intern(fromLabel)];
             State *froms = NULL;
             froms = cfg->LabelMap[label];
-            string toName = s->name;
+            Symbol toName = s->name;
             if(froms){
                 for(unsigned j=0, trsize = froms->transList.size(); j!=trsize; j++){
                     Transition *fromtr = froms->transList[j];
                     if(fromtr->toName==toName){
-                        int tranID = fromtr->ID;
                         fromtr->guardList.push_back(cTemp);
-                        for(unsigned k=0; k<cfg->transitionList.size(); k++){
-                            Transition *trans = &cfg->transitionList[k];
-                            if(trans->ID==tranID){
-                                trans->guardList.push_back(cTemp);
-                            }
-                        }
                     }
                 }
             }
@@ -3845,8 +3811,8 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             st1>>tt1;
             st2<<t2;
             st2>>tt2;
-            tr1=new Transition(t1,"e"+tt1);
-            tr2=new Transition(t2,"e"+tt2);
+            tr1=cfg->arena.make<Transition>(t1,"e"+tt1);
+            tr2=cfg->arena.make<Transition>(t2,"e"+tt2);
             tr1->fromState=s;
             tr1->fromName=s->name;
             tr1->level=s->level+1;
@@ -3863,19 +3829,19 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
 	        string conName = func+"."+conNum;
 
 	        if(isa<ConstantInt>(v)){
-                pTemp1.rvar = new Variable(conNum,-1,INTNUM,numBits);
+                pTemp1.rvar = cfg->terms.var(conNum,-1,INTNUM,numBits);
             }
 	        else if(cfg->hasVariable(conName)){
 	            Variable *var = cfg->getVariable(conName);
 	            if(var->type!=INT)
 	                errs()<<"2.BranchInst error 10086: "<<conName<<"\n";
-	            pTemp1.rvar = new Variable(var);
+	            pTemp1.rvar = cfg->terms.var(var);
 	        }
 	        else
 	        	errs()<<"3.BranchInst error 10086: "<<conName<<"\t"<<*I<<"\n";
         	
 
-	    	pTemp2.rvar = new Variable("1",-1,INTNUM,numBits);
+	    	pTemp2.rvar = cfg->terms.var("1",-1,INTNUM,numBits);
 	    	cTemp1.lpvList = pTemp1;
 	    	cTemp1.rpvList = pTemp2;
 	    	cTemp1.op = NE;
@@ -3890,7 +3856,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             string tt1;
             st1<<t1;
             st1>>tt1;
-            tr1=new Transition(t1,"e"+tt1);
+            tr1=cfg->arena.make<Transition>(t1,"e"+tt1);
             tr1->fromState=s;
             tr1->fromName=s->name;
             tr1->level=s->level+1;
@@ -3910,7 +3876,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
 	
                 if(j==1){//its the left
                     toLabel1=func+"."+varName;
-                    tr1->toLabel=toLabel1;
+                    tr1->toLabel=symbolTable.intern(toLabel1);
                     State* s1 = cfg->getLabelState(toLabel1);
                     if(s1!=NULL)
                     {
@@ -3920,7 +3886,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                 }
                 else if (j==2){
                     toLabel2=func+"."+varName;
-                    tr2->toLabel=toLabel2;
+                    tr2->toLabel=symbolTable.intern(toLabel2);
                     State* s1 = cfg->getLabelState(toLabel2);
                     if(s1!=NULL)
                     {
@@ -3933,15 +3899,13 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                 {
                     tr1->guardList.push_back(cTemp1);
                     tr2->guardList.push_back(cTemp2);
-                    s->transList.push_back(tr1);
-                    s->transList.push_back(tr2);
-                    cfg->transitionList.push_back(*tr1);//follow the transList
-                    cfg->transitionList.push_back(*tr2);//follow the transList
+                    cfg->addTransition(s, tr1);//follow the transList
+                    cfg->addTransition(s, tr2);
                 }
             }
             else if(n1==1){//single br
                 toLabel1=func+"."+varName;
-                tr1->toLabel=toLabel1;
+                tr1->toLabel=symbolTable.intern(toLabel1);
                 State* s1 = cfg->getLabelState(toLabel1);
                 if(s1!=NULL)
                 {
@@ -3949,8 +3913,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                     tr1->toState = s1;
                     s1->level = tr1->level;
                 }
-                s->transList.push_back(tr1);
-                cfg->transitionList.push_back(*tr1);//follow the transList
+                cfg->addTransition(s, tr1);//follow the transList
             }             
         }
 
@@ -3987,7 +3950,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             else{
                 Variable var(c, cfg->counter_variable++, type, numBits);
                 cfg->variableList.push_back(var);
-                pTemp1.rvar = new Variable(var);
+                pTemp1.rvar = cfg->terms.var(var);
                 pTemp1.isExp=false;
             }
         }
@@ -4059,13 +4022,15 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             //constraint in return transition is c==function_ret
                 cfg->retVar.push_back(c);
             }
+            int site = cfg->shareCall(funcName, s->level+1);
+            cfg->callSite.push_back(site);
 
 //**********************set to transition********************************************
             int t;
 
-            map<string ,int >::iterator it=cfg->funcTime.find(funcName);
+            unordered_map<Symbol,int >::iterator it=cfg->funcTime.find(symbolTable.lookup(funcName));
             int time = 0;
-            if(it!=cfg->funcTime.end())
+            if(it!=cfg->funcTime.end()&&site<0)
                 time = it->second+1;
             if(time>0)
                 funcName = funcName+".t"+intToString(time);
@@ -4074,11 +4039,11 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
 
             t =cfg->counter_transition++;
             string tt = intToString(t);
-            Transition *tr=new Transition(t,"e"+tt);
+            Transition *tr=cfg->arena.make<Transition>(t,"e"+tt);
             tr->fromState=s;
             tr->fromName=s->name;
             tr->level=s->level+1;
-            tr->toLabel=toLabel;
+            tr->toLabel=symbolTable.intern(toLabel);
             State* s1 = cfg->getLabelState(toLabel);
             if(s1!=NULL)
             {
@@ -4119,7 +4084,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                                 Variable *var = cfg->getVariable(varName);
                                 if(var->type!=PTR)
                                     errs()<<"2.Call: error 10086: "<<varName<<"\n";
-                                pt2.varList.push_back(new Variable(var));
+                                pt2.varList.push_back(cfg->terms.var(var));
                             }
                             else
                                 errs()<<"3.Call.Getelementptr: error 10086\t"<<varName<<"\n";
@@ -4127,7 +4092,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                             string tempName = c+".t"+intToString(i);
                             Variable tVar(tempName, cfg->counter_variable++, PTR, 0);
                             cfg->variableList.push_back(tVar);
-                            pt1.rvar = new Variable(tVar);
+                            pt1.rvar = cfg->terms.var(tVar);
 
                             pt2.op = GETPTR;
                             pt2.isExp = true;
@@ -4137,14 +4102,14 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                                 string varNum = getVariableName(Out, v2, &TypePrinter, &Machine, TheModule);
                                 if(isa<ConstantInt>(v2)){
                                 	numBits = getNumBits(v2);
-				                    pt2.varList.push_back(new Variable(varNum,-1,INTNUM,numBits));
+				                    pt2.varList.push_back(cfg->terms.var(varNum,-1,INTNUM,numBits));
 				                }
                                 else 
                                     errs()<<"4.Call: error 10086: "<<varNum<<"\n";
     
                             }
                                     
-                            p2.rvar = new Variable(tVar);
+                            p2.rvar = cfg->terms.var(tVar);
                             cTemp1.lpvList = pt1;
                             cTemp1.rpvList = pt2;
                             s->consList.push_back(cTemp1);
@@ -4165,17 +4130,17 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                                 varName = setGlobal(varNum, v1, cfg, s);
             //                    errs()<<"call isa<GlobalVariable>: "<<varName<<"\n";
                                 Variable *var = cfg->getVariable(varName);
-                                p2.rvar = new Variable(var);
+                                p2.rvar = cfg->terms.var(var);
                             }
                             else if(isa<ConstantInt>(v1)){
-				                p2.rvar = new Variable(varNum,-1,INTNUM,numBits);
+				                p2.rvar = cfg->terms.var(varNum,-1,INTNUM,numBits);
 				            }
 				            else if(isa<ConstantFP>(v1)){
-					            p2.rvar = new Variable(varNum,-1,FPNUM,numBits);
+					            p2.rvar = cfg->terms.var(varNum,-1,FPNUM,numBits);
 					        } 
                             else if(cfg->hasVariable(varName)){
                                 Variable *var = cfg->getVariable(varName);
-                                p2.rvar = new Variable(var);
+                                p2.rvar = cfg->terms.var(var);
                             }
                             /*
                             else if(isa<ConstantPointerNull>(v1)){           
@@ -4191,24 +4156,34 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
                                 varName = setGlobal(varNum, v1, cfg, s);
             //                    errs()<<"call isa<GlobalVariable>: "<<varName<<"\n";
                                 Variable *var = cfg->getVariable(varName);
-                                p2.rvar = new Variable(var);
+                                p2.rvar = cfg->terms.var(var);
                             }    
                             else if(cfg->hasVariable(varName)){
                                 Variable *var = cfg->getVariable(varName);
-                                p2.rvar = new Variable(var);
+                                p2.rvar = cfg->terms.var(var);
                             }
                             else {
                                 errs()<<funcName<<"6. call error: 10086!!: "<<varName<<"\t"<<*I<<"\n";
                             }
                         }
                     }
-                    cfg->callVar.push_back(p2);
+                    if(site<0)
+                        cfg->callVar.push_back(p2);
+                    else{
+                        //the shared body reads its arguments from the call transition
+                        Constraint cTemp1;
+                        cTemp1.lpvList.rvar = cfg->terms.var(argVariable(cfg, &*it, funcName));
+                        cTemp1.rpvList = p2;
+                        cTemp1.op=ASSIGN;
+                        tr->guardList.push_back(cTemp1);
+                    }
                     i++;
                 }
+                if(site>=0)
+                    tr->guardList.push_back(cfg->siteConstraint(funcName, site, ASSIGN));
             }
 
-            s->transList.push_back(tr);
-            cfg->transitionList.push_back(*tr);
+            cfg->addTransition(s, tr);
             return;
 
         }
@@ -4236,11 +4211,11 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             string varName = func+"."+varNum;
             numBits = getNumBits(v1);
 
-            pTemp1.rvar = new Variable("1",-1,INTNUM,numBits);
+            pTemp1.rvar = cfg->terms.var("1",-1,INTNUM,numBits);
             if(cfg->hasVariable(varName)){
             	Variable *var = cfg->getVariable(varName);
             	assert(numBits==var->numbits && "__VERIFIER_assume argument error!!!");
-                pTemp2.rvar = new Variable(var);
+                pTemp2.rvar = cfg->terms.var(var);
             }
             cTemp.op = EQ;
             cTemp.lpvList = pTemp2;
@@ -4280,16 +4255,16 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             string varNum = getVariableName(Out, v1, &TypePrinter, &Machine, TheModule);
             string varName = func+"."+varNum;
             if(isa<ConstantInt>(v1)){
-				pTemp2.rvar = new Variable(varNum,-1,INTNUM,numBits);
+				pTemp2.rvar = cfg->terms.var(varNum,-1,INTNUM,numBits);
 			}
 			else if(isa<ConstantFP>(v1)){
-				pTemp2.rvar = new Variable(varNum,-1,FPNUM,numBits);
+				pTemp2.rvar = cfg->terms.var(varNum,-1,FPNUM,numBits);
 			} 
             // if(isConstantVal(v1))
             //     pTemp2.rvar = new Variable(varNum,-1,NUM);    
             else if(cfg->hasVariable(varName)){
                 Variable *var = cfg->getVariable(varName);
-                pTemp2.rvar = new Variable(var);
+                pTemp2.rvar = cfg->terms.var(var);
             }
             else
                 errs()<<funcName<<"8. call error: 10086!!: "<<varName<<"\t"<<*I<<"\n";
@@ -4300,16 +4275,16 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             string varNum = getVariableName(Out, v1, &TypePrinter, &Machine, TheModule);
             string varName = func+"."+varNum;
             if(isa<ConstantInt>(v1)){
-				pTemp2.rvar = new Variable(varNum,-1,INTNUM,numBits);
+				pTemp2.rvar = cfg->terms.var(varNum,-1,INTNUM,numBits);
 			}
 			else if(isa<ConstantFP>(v1)){
-				pTemp2.rvar = new Variable(varNum,-1,FPNUM,numBits);
+				pTemp2.rvar = cfg->terms.var(varNum,-1,FPNUM,numBits);
 			} 
             // if(isConstantVal(v1))
             //     pTemp2.rvar = new Variable(varNum,-1,NUM);    
             else if(cfg->hasVariable(varName)){
                 Variable *var = cfg->getVariable(varName);
-                pTemp2.rvar = new Variable(var);
+                pTemp2.rvar = cfg->terms.var(var);
             }
             else
                 errs()<<funcName<<"9. call error: 10086!!: "<<varName<<"\t"<<*I<<"\n";
@@ -4319,16 +4294,16 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             varNum = getVariableName(Out, v1, &TypePrinter, &Machine, TheModule);
             varName = func+"."+varNum;
             if(isa<ConstantInt>(v1)){
-				pTemp2.lvar = new Variable(varNum,-1,INTNUM,numBits);
+				pTemp2.lvar = cfg->terms.var(varNum,-1,INTNUM,numBits);
 			}
 			else if(isa<ConstantFP>(v1)){
-				pTemp2.lvar = new Variable(varNum,-1,FPNUM,numBits);
+				pTemp2.lvar = cfg->terms.var(varNum,-1,FPNUM,numBits);
 			} 
             // if(isConstantVal(v1))
             //     pTemp2.lvar = new Variable(varNum,-1,NUM);    
             else if(cfg->hasVariable(varName)){
                 Variable *var = cfg->getVariable(varName);
-                pTemp2.lvar = new Variable(var);
+                pTemp2.lvar = cfg->terms.var(var);
             }
             else
                 errs()<<funcName<<"8. call error: 10086!!: "<<varName<<"\t"<<*I<<"\n";
@@ -4354,12 +4329,13 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
 
         int t =cfg->counter_transition++;
         string tt = intToString(t);
-        Transition *tr=new Transition(t,"e"+tt);
+        Transition *tr=cfg->arena.make<Transition>(t,"e"+tt);
         tr->fromState=s;
         tr->fromName=s->name;
         tr->level=s->level+1;
-        tr->toLabel=func+".ret";
-        State* s1 = cfg->getLabelState(tr->toLabel);
+        string toLabel=func+".ret";
+        tr->toLabel=symbolTable.intern(toLabel);
+        State* s1 = cfg->getLabelState(toLabel);
         if(s1!=NULL)
         {
             tr->toName = s1->name;
@@ -4382,27 +4358,27 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             ParaVariable p1,p2;
             if(cfg->hasVariable(ret)){
                 Variable *var = cfg->getVariable(ret);
-                p1.rvar = new Variable(var);//new Variable(ret,var->ID,var->type);    
+                p1.rvar = cfg->terms.var(var);//new Variable(ret,var->ID,var->type);    
             }
             else
                 errs()<<"2.RetInst:10086\n";
 
             if(isa<ConstantInt>(v1)){
             	numBits = getNumBits(v1);
-				p2.rvar = new Variable(varNum,-1,INTNUM,numBits);
+				p2.rvar = cfg->terms.var(varNum,-1,INTNUM,numBits);
 			}
 			else if(isa<ConstantFP>(v1)){
             	numBits = getNumBits(v1);
-				p2.rvar = new Variable(varNum,-1,FPNUM,numBits);
+				p2.rvar = cfg->terms.var(varNum,-1,FPNUM,numBits);
 			} 
             // if(isConstantVal(v1))
             //     p2.rvar = new Variable(varNum,-1,NUM);
             else if(isa<ConstantPointerNull>(v1)){                                  
-                p2.rvar = new Variable("0",-1,PTR,0);
+                p2.rvar = cfg->terms.var("0",-1,PTR,0);
             }
             else if(cfg->hasVariable(varName)){
                 Variable *var = cfg->getVariable(varName);
-                p2.rvar = new Variable(var);//new Variable(varName,->ID,false);    
+                p2.rvar = cfg->terms.var(var);//new Variable(varName,->ID,false);    
             }
             else
                 errs()<<"3.RetInst:10086 "<<varName<<"\n";
@@ -4413,8 +4389,14 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             tr->guardList.push_back(cTemp1);
         }
 
-        s->transList.push_back(tr);
-        cfg->transitionList.push_back(*tr);
+        //the body is shared by -summary: this return belongs to the first call site,
+        //CFG::bindReturns copies it for the others
+        unordered_map<Symbol,CFG::CallSummary>::iterator sum = cfg->summaries.find(symbolTable.lookup(func));
+        if(sum!=cfg->summaries.end())
+            tr->guardList.push_back(cfg->siteConstraint(func, 0, EQ));
+        cfg->addTransition(s, tr);
+        if(sum!=cfg->summaries.end())
+            sum->second.rets.push_back(tr);
     }
 
     else if(op=="getelementptr"){
@@ -4438,7 +4420,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
         else{
             Variable var(c, cfg->counter_variable++, PTR, 0);
             cfg->variableList.push_back(var);
-            pTemp1.rvar = new Variable(var);
+            pTemp1.rvar = cfg->terms.var(var);
             pTemp1.isExp=false;
         }
         
@@ -4455,7 +4437,7 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
 
         if(cfg->hasVariable(varName)){
         	Variable *var = cfg->getVariable(varName);
-            pTemp2.varList.push_back(new Variable(var));
+            pTemp2.varList.push_back(cfg->terms.var(var));
         }
         else
             errs()<<"3.Getelementptr: error 10086\t"<<varName<<"\n";
@@ -4468,11 +4450,11 @@ void InstParser::setConstraint(CFG* cfg, State* &s, BasicBlock::iterator &it, st
             varName = func+"."+varNum;
             if(isa<ConstantInt>(v1)){
             	numBits = getNumBits(v1);
-				pTemp2.varList.push_back(new Variable(varNum,-1,INTNUM,numBits));
+				pTemp2.varList.push_back(cfg->terms.var(varNum,-1,INTNUM,numBits));
 			}
             else if(cfg->hasVariable(varName)){
                 Variable *var = cfg->getVariable(varName);
-                pTemp2.varList.push_back(new Variable(var));    
+                pTemp2.varList.push_back(cfg->terms.var(var));    
             }
             else
                 errs()<<"4.Getelementptr: error 10086\t"<<*v1<<"\n";
@@ -4510,7 +4492,7 @@ string InstParser::setGlobalConstraint(string name, Constant *Initial, CFG *cfg,
         Variable pvar;
         if(!cfg->hasVariable(name)){
             //set ptr var
-            pvar = new Variable(name, cfg->counter_variable++, PTR, 0);
+            pvar = cfg->terms.var(name, cfg->counter_variable++, PTR, 0);
             cfg->variableList.push_back(pvar);
         }
         else{
@@ -4520,7 +4502,7 @@ string InstParser::setGlobalConstraint(string name, Constant *Initial, CFG *cfg,
         string dataName = name+".0";
         Constraint cTemp1;
         ParaVariable p1,p2;
-        p1.rvar = new Variable(pvar);
+        p1.rvar = cfg->terms.var(pvar);
         cTemp1.op = ASSIGN;
         p2.isExp = true;
         if(Initial->getType()->isSingleValueType()){
@@ -4529,10 +4511,10 @@ string InstParser::setGlobalConstraint(string name, Constant *Initial, CFG *cfg,
             cTemp1.lpvList = p1;
             cTemp1.rpvList = p2;
             unsigned numBits = 0;
-            if(cfg->stateList[0].isInitial==false)
+            if(cfg->stateList[0]->isInitial==false)
                 s->consList.push_back(cTemp1);
             else
-                cfg->stateList[0].consList.push_back(cTemp1);
+                cfg->stateList[0]->consList.push_back(cTemp1);
             
             if(!cfg->hasVariable(dataName)){
                 //set dataVar
@@ -4557,19 +4539,19 @@ string InstParser::setGlobalConstraint(string name, Constant *Initial, CFG *cfg,
                 Constraint cTemp;
                 ParaVariable pTemp1,pTemp2;
                 cTemp.op=ASSIGN;
-                pTemp1.rvar = new Variable(dataVar);
+                pTemp1.rvar = cfg->terms.var(dataVar);
                 if(isa<ConstantInt>(Initial)){
                     const ConstantInt *con = dyn_cast<ConstantInt>(Initial); 
                     double value = con->getValue().signedRoundToDouble();
                     string num = double2string(value);
-                    pTemp2.rvar = new Variable(num,-1,INTNUM,numBits);
+                    pTemp2.rvar = cfg->terms.var(num,-1,INTNUM,numBits);
                 }
                 else if(isa<ConstantFP>(Initial)){
                     const ConstantFP *con = dyn_cast<ConstantFP>(Initial); 
                     APFloat apf = con->getValueAPF();
                     APInt convt = apf.bitcastToAPInt();
                     string num = convt.toString(10,true);
-                    pTemp2.rvar = new Variable(num,-1,FPNUM,numBits);
+                    pTemp2.rvar = cfg->terms.var(num,-1,FPNUM,numBits);
                 }
                 else if(isa<ConstantExpr>(Initial)){
                     ConstantExpr *expr = dyn_cast<ConstantExpr>(Initial);
@@ -4592,7 +4574,7 @@ string InstParser::setGlobalConstraint(string name, Constant *Initial, CFG *cfg,
                         Variable *var = cfg->getVariable(varName);
                         if(var->type!=PTR)
                             errs()<<"2.Set global: error 10086: "<<varName<<"\n";
-                        pt2.varList.push_back(new Variable(var));
+                        pt2.varList.push_back(cfg->terms.var(var));
                     }
                     else
                         errs()<<"3.Set global error 10086\t"<<varName<<"\n";
@@ -4601,7 +4583,7 @@ string InstParser::setGlobalConstraint(string name, Constant *Initial, CFG *cfg,
                     string tempName = dataName+".t";
                     Variable tVar(tempName, cfg->counter_variable++, PTR, 0);
                     cfg->variableList.push_back(tVar);
-                    pt1.rvar = new Variable(tVar);
+                    pt1.rvar = cfg->terms.var(tVar);
 
                     pt2.op = GETPTR;
                     pt2.isExp = true;
@@ -4612,7 +4594,7 @@ string InstParser::setGlobalConstraint(string name, Constant *Initial, CFG *cfg,
                         string varNum = getVariableName(Out, v2, &TypePrinter, &Machine, TheModule);
                         if(isa<ConstantInt>(v2)){
                         	numBits = getNumBits(v2);
-                            pt2.varList.push_back(new Variable(varNum,-1,INTNUM,numBits));
+                            pt2.varList.push_back(cfg->terms.var(varNum,-1,INTNUM,numBits));
                         }
                         else 
                             errs()<<"4.Set global: error 10086: "<<varNum<<"\n";
@@ -4621,15 +4603,15 @@ string InstParser::setGlobalConstraint(string name, Constant *Initial, CFG *cfg,
                     con.lpvList = pt1;
                     con.rpvList = pt2;
 //                  
-                    if(cfg->stateList[0].isInitial==false)
+                    if(cfg->stateList[0]->isInitial==false)
                         s->consList.push_back(con);
                     else
-                        cfg->stateList[0].consList.push_back(con);
+                        cfg->stateList[0]->consList.push_back(con);
                         
-                    pTemp2.rvar = new Variable(tVar);
+                    pTemp2.rvar = cfg->terms.var(tVar);
                 }
                 else if(isa<ConstantPointerNull>(Initial)){
-                    pTemp2.rvar = new Variable("0",-1,PTR,0);
+                    pTemp2.rvar = cfg->terms.var("0",-1,PTR,0);
                 }
                 else
                     errs()<<"1.GlobalVariable error 10086"<<*Initial<<"\n";
@@ -4637,14 +4619,14 @@ string InstParser::setGlobalConstraint(string name, Constant *Initial, CFG *cfg,
                 cTemp.lpvList = pTemp1;
                 cTemp.rpvList = pTemp2;
     
-                if(cfg->stateList[0].isInitial==false)
+                if(cfg->stateList[0]->isInitial==false)
                     s->consList.push_back(cTemp);
                 else
-                    cfg->stateList[0].consList.push_back(cTemp);
+                    cfg->stateList[0]->consList.push_back(cTemp);
                 
                 //var = store dataVar
                 p2.op = STORE;
-                p2.rvar = new Variable(dataVar);
+                p2.rvar = cfg->terms.var(dataVar);
                 cfg->exprList.push_back(dataVar);
             }
             else
@@ -4752,7 +4734,7 @@ string InstParser::setGlobalConstraint(string name, Constant *Initial, CFG *cfg,
                     }
                 }
                 p2.op = ADDR;
-                p2.rvar = new Variable(dataVar);
+                p2.rvar = cfg->terms.var(dataVar);
                 p2.isExp = true;
             }
             else
@@ -4760,10 +4742,10 @@ string InstParser::setGlobalConstraint(string name, Constant *Initial, CFG *cfg,
         }
         cTemp1.lpvList = p1;
         cTemp1.rpvList = p2;
-        if(cfg->stateList[0].isInitial==false)
+        if(cfg->stateList[0]->isInitial==false)
             s->consList.push_back(cTemp1);
         else
-            cfg->stateList[0].consList.push_back(cTemp1);
+            cfg->stateList[0]->consList.push_back(cTemp1);
         
         return name;
 }
@@ -4775,7 +4757,7 @@ void InstParser::setVariable(CFG* cfg, State * s, Type *Ty, string name, bool in
     Variable pvar;
     if(!cfg->hasVariable(name)){
             //set ptr var
-        pvar = new Variable(name, cfg->counter_variable++, PTR, 0);
+        pvar = cfg->terms.var(name, cfg->counter_variable++, PTR, 0);
         cfg->variableList.push_back(pvar);
     }
     else{
@@ -4784,7 +4766,7 @@ void InstParser::setVariable(CFG* cfg, State * s, Type *Ty, string name, bool in
     }            
     Constraint cTemp1;
     ParaVariable p1,p2;
-    p1.rvar = new Variable(pvar);
+    p1.rvar = cfg->terms.var(pvar);
     cTemp1.op = ASSIGN;
     p2.isExp = true;
     if(Ty->isSingleValueType()){
@@ -4830,7 +4812,7 @@ void InstParser::setVariable(CFG* cfg, State * s, Type *Ty, string name, bool in
         else{
             s->consList.push_back(cTemp1);
         }
-        p2.rvar = new Variable(dataVar);
+        p2.rvar = cfg->terms.var(dataVar);
         p2.op = STORE;
         cfg->exprList.push_back(dataVar);
     }
@@ -4871,7 +4853,7 @@ void InstParser::setVariable(CFG* cfg, State * s, Type *Ty, string name, bool in
             }
         }
         p2.op = ADDR;
-        p2.rvar = new Variable(dataVar);
+        p2.rvar = cfg->terms.var(dataVar);
     }
     
     cTemp1.lpvList = p1;
@@ -4939,16 +4921,16 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
                 ParaVariable pTemp1,pTemp2;
                 Variable *var = cfg->getVariable(varName);
                 VarType type = var->type;
-                pTemp1.rvar = new Variable(var);
+                pTemp1.rvar = cfg->terms.var(var);
                 cTemp.lpvList = pTemp1;
                 cTemp.op=(type==INT)?EQ:FEQ;
 
-                pTemp2.rvar = new Variable("0",-1,type,numBits);
+                pTemp2.rvar = cfg->terms.var("0",-1,type,numBits);
                 cTemp.rpvList = pTemp2;
             
                 int id = cfg->counter_state++;
                 string name = "q"+intToString(cfg->counter_q_state++);
-                State *qState = new State(false, id, name, func);
+                State *qState = cfg->arena.make<State>(false, id, name, func);
                 qState->error=Spec;
                 cfg->stateList.resize(id+1);
                 qState->transList.clear();
@@ -4957,54 +4939,54 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
                 qState->locList.push_back(Line);
 
                 int t =cfg->counter_transition++;
-                Transition *temp=new Transition(t,"e"+intToString(t));
+                Transition *temp=cfg->arena.make<Transition>(t,"e"+intToString(t));
                 temp->fromState=s;
                 temp->fromName=s->name;
                 temp->toState=qState;
-                temp->toName=name;
+                temp->toName=temp->toState->name;
                 temp->level=s->level+1;
                 qState->level=temp->level;
                 temp->guardList.clear();
             
                 temp->guardList.push_back(cTemp);
 
-                cfg->stateList[qState->ID] = (*qState);
+                cfg->stateList[qState->ID] = qState;
 
-                cfg->transitionList.push_back(*temp);
+                cfg->transitionList.push_back(temp);
                 target.push_back(qState->ID);
 
-                cfg->stateList[s->ID] = (*s);
+                cfg->stateList[s->ID] = s;
 
             //	constraint above is var==0
             //	constraint below is var!=0
                 cTemp.op=(type==INT)?NE:FNE;
-                pTemp2.rvar = new Variable("0",-1,type,numBits);
+                pTemp2.rvar = cfg->terms.var("0",-1,type,numBits);
                 cTemp.rpvList = pTemp2;
 
                 t = cfg->counter_transition++;
-                temp = new Transition(t, "e"+intToString(t));
+                temp = cfg->arena.make<Transition>(t, "e"+intToString(t));
                 temp->fromState = s;
                 temp->fromName = s->name;
                 temp->level=s->level+1;
             
                 id = cfg->counter_state++;
                 name = "s"+intToString(cfg->counter_s_state++);
-                s = new State(false, id, name, func);
+                s = cfg->arena.make<State>(false, id, name, func);
                 cfg->stateList.resize(id+1);
 
                 temp->toState = s;
-                temp->toName = name;
+                temp->toName = temp->toState->name;
                 s->level=temp->level;
                 temp->guardList.clear();
                 temp->guardList.push_back(cTemp);
-                cfg->transitionList.push_back(*temp);
+                cfg->transitionList.push_back(temp);
             }
         }
         // if(funcName == "__assert_fail"&&mode!=2)
         if((f->doesNotReturn()||f->getName()=="__VERIFIER_error")&&mode!=2){
                 int id = cfg->counter_state++;
                 string name = "q"+intToString(cfg->counter_q_state++);
-                State *qState = new State(false, id, name, func);
+                State *qState = cfg->arena.make<State>(false, id, name, func);
                 qState->error=Assert;
                 cfg->stateList.resize(id+1);
                 qState->transList.clear();
@@ -5013,17 +4995,17 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
                 qState->locList.push_back(Line);
 
                 int t =cfg->counter_transition++;
-                Transition *temp=new Transition(t,"e"+intToString(t));
+                Transition *temp=cfg->arena.make<Transition>(t,"e"+intToString(t));
                 temp->fromState=s;
                 temp->fromName=s->name;
                 temp->toState=qState;
-                temp->toName=name;
+                temp->toName=temp->toState->name;
                    temp->level=s->level+1;
                    qState->level=temp->level;
                 temp->guardList.clear();
 
-                cfg->stateList[qState->ID] = (*qState);
-                cfg->transitionList.push_back(*temp);
+                cfg->stateList[qState->ID] = qState;
+                cfg->transitionList.push_back(temp);
                 target.push_back(qState->ID);
         }
         else if(funcName=="sqrt"&&mode!=1){
@@ -5038,16 +5020,16 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
                 ParaVariable pTemp1,pTemp2;
                 Variable *var = cfg->getVariable(varName);
                 VarType type = var->type;
-                pTemp1.rvar = new Variable(var);
+                pTemp1.rvar = cfg->terms.var(var);
 
-                pTemp2.rvar = new Variable("0",-1,type,numBits);
+                pTemp2.rvar = cfg->terms.var("0",-1,type,numBits);
                 cTemp.lpvList = pTemp1;
                 cTemp.op=(type==INT)?SLT:FLT;
                 cTemp.rpvList = pTemp2;
             
                 int id = cfg->counter_state++;
                 string name = "q"+intToString(cfg->counter_q_state++);
-                State *qState = new State(false, id, name, func);
+                State *qState = cfg->arena.make<State>(false, id, name, func);
                 qState->error=DomainSqrt;
                 cfg->stateList.resize(id+1);
                 qState->transList.clear();
@@ -5056,40 +5038,40 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
                 qState->locList.push_back(Line);
 
                 int t =cfg->counter_transition++;
-                Transition *temp=new Transition(t,"e"+intToString(t));
+                Transition *temp=cfg->arena.make<Transition>(t,"e"+intToString(t));
                 temp->fromState=s;
                 temp->fromName=s->name;
                 temp->toState=qState;
-                temp->toName=name;
+                temp->toName=temp->toState->name;
                 temp->level=s->level+1;
                 qState->level=temp->level;
                 temp->guardList.clear();
             
                 temp->guardList.push_back(cTemp);
 
-                cfg->stateList[qState->ID] = (*qState);
+                cfg->stateList[qState->ID] = qState;
 //                errs()<<"SQRT\t"<<*qState<<"\n";
-                cfg->transitionList.push_back(*temp);
+                cfg->transitionList.push_back(temp);
                 target.push_back(qState->ID);
 
-                cfg->stateList[s->ID] = (*s);
+                cfg->stateList[s->ID] = s;
 //                errs()<<"1.SQRT\t"<<*s<<"\n";
                 t = cfg->counter_transition++;
-                temp = new Transition(t, "e"+intToString(t));
+                temp = cfg->arena.make<Transition>(t, "e"+intToString(t));
                 temp->fromState = s;
                 temp->fromName = s->name;
                 temp->level=s->level+1;
             
                 id = cfg->counter_state++;
                 name = "s"+intToString(cfg->counter_s_state++);
-                s = new State(false, id, name, func);
+                s = cfg->arena.make<State>(false, id, name, func);
                 cfg->stateList.resize(id+1);
 
                 temp->toState = s;
-                temp->toName = name;
+                temp->toName = temp->toState->name;
                    s->level=temp->level;
                 temp->guardList.clear();
-                cfg->transitionList.push_back(*temp);
+                cfg->transitionList.push_back(temp);
             }
         }
         else if(isLogFunc(funcName)&&mode!=1){
@@ -5104,16 +5086,16 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
                 ParaVariable pTemp1,pTemp2;
                 Variable *var = cfg->getVariable(varName);
                 VarType type = var->type;
-                pTemp1.rvar = new Variable(var);
+                pTemp1.rvar = cfg->terms.var(var);
 
-                pTemp2.rvar = new Variable("0",-1,type,numBits);
+                pTemp2.rvar = cfg->terms.var("0",-1,type,numBits);
                 cTemp.lpvList = pTemp1;
                 cTemp.op=(type==INT)?SLE:FLE;
                 cTemp.rpvList = pTemp2;
             
                 int id = cfg->counter_state++;
                 string name = "q"+intToString(cfg->counter_q_state++);
-                State *qState = new State(false, id, name, func);
+                State *qState = cfg->arena.make<State>(false, id, name, func);
                 qState->error=DomainLog;
                 cfg->stateList.resize(id+1);
                 qState->transList.clear();
@@ -5122,40 +5104,40 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
                 qState->locList.push_back(Line);
 
                 int t =cfg->counter_transition++;
-                Transition *temp=new Transition(t,"e"+intToString(t));
+                Transition *temp=cfg->arena.make<Transition>(t,"e"+intToString(t));
                 temp->fromState=s;
                 temp->fromName=s->name;
                 temp->toState=qState;
-                temp->toName=name;
+                temp->toName=temp->toState->name;
                 temp->level=s->level+1;
                 qState->level=temp->level;
                 temp->guardList.clear();
             
                 temp->guardList.push_back(cTemp);
 
-                cfg->stateList[qState->ID] = (*qState);
+                cfg->stateList[qState->ID] = qState;
   //              errs()<<"LOG\t"<<*qState<<"\n";
-                cfg->transitionList.push_back(*temp);
+                cfg->transitionList.push_back(temp);
                 target.push_back(qState->ID);
 
-                cfg->stateList[s->ID] = (*s);
+                cfg->stateList[s->ID] = s;
  //               errs()<<"1.LOG\t"<<*s<<"\n";
                 t = cfg->counter_transition++;
-                temp = new Transition(t, "e"+intToString(t));
+                temp = cfg->arena.make<Transition>(t, "e"+intToString(t));
                 temp->fromState = s;
                 temp->fromName = s->name;
                 temp->level=s->level+1;
             
                 id = cfg->counter_state++;
                 name = "s"+intToString(cfg->counter_s_state++);
-                s = new State(false, id, name, func);
+                s = cfg->arena.make<State>(false, id, name, func);
                 cfg->stateList.resize(id+1);
 
                 temp->toState = s;
-                temp->toName = name;
+                temp->toName = temp->toState->name;
                 s->level=temp->level;
                 temp->guardList.clear();
-                cfg->transitionList.push_back(*temp);
+                cfg->transitionList.push_back(temp);
             }
         }
         else if(isTriangleFunc(funcName)&&mode!=1){
@@ -5169,7 +5151,7 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
             
                 int id = cfg->counter_state++;
                 string name = "q"+intToString(cfg->counter_q_state++);
-                State *qState = new State(false, id, name, func);
+                State *qState = cfg->arena.make<State>(false, id, name, func);
                 qState->error=DomainTri;
                 cfg->stateList.resize(id+1);
                 qState->transList.clear();
@@ -5178,11 +5160,11 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
                 qState->locList.push_back(Line);
 
                 int t =cfg->counter_transition++;
-                Transition *temp=new Transition(t,"e"+intToString(t));
+                Transition *temp=cfg->arena.make<Transition>(t,"e"+intToString(t));
                 temp->fromState=s;
                 temp->fromName=s->name;
                 temp->toState=qState;
-                temp->toName=name;
+                temp->toName=temp->toState->name;
                 temp->level=s->level+1;
                 qState->level=temp->level;
                 temp->guardList.clear();
@@ -5199,19 +5181,19 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
                 else{
                     Variable tvar(tempName, cfg->counter_variable++, type, numBits);
                     cfg->variableList.push_back(tvar);
-                    pTemp1.rvar = new Variable(tvar);
+                    pTemp1.rvar = cfg->terms.var(tvar);
                     pTemp1.isExp=false;
                     cTemp.lpvList = pTemp1;
                 }
 
                 pTemp2.isExp = true;
                 pTemp2.op = (type==INT)?ABS:FABS;
-                pTemp2.rvar = new Variable(var);
+                pTemp2.rvar = cfg->terms.var(var);
                 cTemp.rpvList = pTemp2;
                 cTemp.op = ASSIGN;
                 temp->guardList.push_back(cTemp);
 
-                pTemp2.rvar = new Variable("1",-1,type,numBits);
+                pTemp2.rvar = cfg->terms.var("1",-1,type,numBits);
                 pTemp2.op = NONE;
                 pTemp2.isExp = false;
                 cTemp.op=(type==INT)?SGT:FGT;
@@ -5219,29 +5201,29 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
 
                 temp->guardList.push_back(cTemp);
 
-                cfg->stateList[qState->ID] = (*qState);
+                cfg->stateList[qState->ID] = qState;
  //               errs()<<"TRI\t"<<*qState<<"\n";
-                cfg->transitionList.push_back(*temp);
+                cfg->transitionList.push_back(temp);
                 target.push_back(qState->ID);
 
-                cfg->stateList[s->ID] = (*s);
+                cfg->stateList[s->ID] = s;
 //                errs()<<"1.TRI\t"<<*s<<"\n";
                 t = cfg->counter_transition++;
-                temp = new Transition(t, "e"+intToString(t));
+                temp = cfg->arena.make<Transition>(t, "e"+intToString(t));
                 temp->fromState = s;
                 temp->fromName = s->name;
                 temp->level=s->level+1;
             
                 id = cfg->counter_state++;
                 name = "s"+intToString(cfg->counter_s_state++);
-                s = new State(false, id, name, func);
+                s = cfg->arena.make<State>(false, id, name, func);
                 cfg->stateList.resize(id+1);
 
                 temp->toState = s;
-                temp->toName = name;
+                temp->toName = temp->toState->name;
                 s->level=temp->level;
                 temp->guardList.clear();
-                cfg->transitionList.push_back(*temp);
+                cfg->transitionList.push_back(temp);
             }
         }
     }
@@ -5257,7 +5239,7 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
             
             int id = cfg->counter_state++;
             string name = "q"+intToString(cfg->counter_q_state++);
-            State *qState = new State(false, id, name, func);
+            State *qState = cfg->arena.make<State>(false, id, name, func);
             qState->error=Div0;
             cfg->stateList.resize(id+1);
 
@@ -5267,13 +5249,13 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
             qState->consList.clear();
             
             int t =cfg->counter_transition++;
-            Transition *temp=new Transition(t,"e"+intToString(t));
+            Transition *temp=cfg->arena.make<Transition>(t,"e"+intToString(t));
             temp->fromState=s;
             temp->fromName=s->name;
             temp->toState=qState;
             temp->level=s->level+1;
             qState->level=temp->level;
-            temp->toName=name;
+            temp->toName=temp->toState->name;
             temp->guardList.clear();
             
             Constraint cTemp;
@@ -5287,26 +5269,26 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
             else{
                 Variable tvar(tempName, cfg->counter_variable++, type, numBits);
                 cfg->variableList.push_back(tvar);
-                pTemp1.rvar = new Variable(tvar);
+                pTemp1.rvar = cfg->terms.var(tvar);
                 pTemp1.isExp=false;
                 cTemp.lpvList = pTemp1;
             }
 
             pTemp2.isExp = true;
             pTemp2.op = (type==INT)?ABS:FABS;
-            pTemp2.rvar = new Variable(var);
+            pTemp2.rvar = cfg->terms.var(var);
             cTemp.rpvList = pTemp2;
             cTemp.op = ASSIGN;
             temp->guardList.push_back(cTemp);
 
             if(type == FP) {
-                pTemp2.rvar = new Variable(double2string(precision),-1,FPNUM,numBits);
+                pTemp2.rvar = cfg->terms.var(double2string(precision),-1,FPNUM,numBits);
                 pTemp2.op = NONE;
             	pTemp2.isExp = false;
             	cTemp.op=FLT;
             }
             else if(type == INT){
-            	pTemp2.rvar = new Variable("0",-1,INTNUM,numBits);
+            	pTemp2.rvar = cfg->terms.var("0",-1,INTNUM,numBits);
                 pTemp2.op = NONE;
             	pTemp2.isExp = false;
             	cTemp.op=EQ;
@@ -5317,31 +5299,31 @@ void InstParser::preprocess(CFG* cfg, State* &s, const Instruction* I, string fu
 
             temp->guardList.push_back(cTemp);
 
-            cfg->stateList[qState->ID] = (*qState);
+            cfg->stateList[qState->ID] = qState;
 //            errs()<<"DIV\t"<<*qState<<"\n";
             
-            cfg->transitionList.push_back(*temp);
+            cfg->transitionList.push_back(temp);
             
             target.push_back(qState->ID);
             
-            cfg->stateList[s->ID] = (*s);
+            cfg->stateList[s->ID] = s;
 //            errs()<<"1.DIV\t"<<*s<<"\n";
             t = cfg->counter_transition++;
-            temp = new Transition(t, "e"+intToString(t));
+            temp = cfg->arena.make<Transition>(t, "e"+intToString(t));
             temp->fromState = s;
             temp->fromName = s->name;
             temp->level=s->level+1;
 
             id = cfg->counter_state++;
             name = "s"+intToString(cfg->counter_s_state++);
-            s = new State(false, id, name, func);
+            s = cfg->arena.make<State>(false, id, name, func);
             cfg->stateList.resize(id+1);
 
             temp->toState = s;
             s->level = temp->level;
-            temp->toName = name;
+            temp->toName = temp->toState->name;
             temp->guardList.clear();
-            cfg->transitionList.push_back(*temp);
+            cfg->transitionList.push_back(temp);
         }
         else
             return;
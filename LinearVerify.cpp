@@ -4,6 +4,8 @@
 using namespace std;
 int VERBOSE_LEVEL = 0;
 int UC_LEVEL=0;
+unsigned MUS_BUDGET=0;
+int MUS_JOBS=1;
 
 //add constraint to empty vector  0==0
 
@@ -29,100 +31,109 @@ Z3_sort getFPsort(z3::context &ctx, unsigned numBits){
 }
 
 const int BitPerByte = 8;
+//encodings kept per node and time frame
+const unsigned MEMO_VARIANTS = 4;
+//encodings kept in total before the memo is dropped
+const unsigned MEMO_LIMIT = 20000;
+//selectors of the persistent solver before it is rebuilt
+const unsigned INC_SELECTOR_LIMIT = 20000;
 
 /***************************table of variables in linear constraints*********************************/
-    LinearVarTable::LinearVarTable(z3::context &ctx, CFG *ha){
-
+    LinearVarTable::LinearVarTable(z3::context &c, CFG *ha):varVal(0), storeMap(0), alias(0), x(z3::expr(c)), ctx(c){
         cfg = ha;
-        unsigned inputID=0;
         var_num = 0;
         alloca_num = 0;
-//        for(int i=0; i<cfg->mainInput.size();i++)
-//            errs()<<"LinearVarTable initial "<<cfg->mainInput[i]<<"\t"<<cfg->variableList[cfg->mainInput[i]].name<<"\n";
-        for(unsigned i=0;i<cfg->variableList.size();i++)
-        {
-            Variable var =  cfg->variableList[i];
-            VarType type = var.type;
-            unsigned numBits = var.numbits;
+        firstNum = -2;
+    }
 
-            if(inputID<cfg->mainInput.size()&&cfg->mainInput[inputID]==i){
+    LinearVarTable::~LinearVarTable(){cfg=NULL;}
 
-                if(type==FP){
-    				Z3_sort fp_sort = getFPsort(ctx, numBits);
+    /* forget the path encoded before, only the entries it touched are reverted */
+    void LinearVarTable::reset(){
+        varVal.clear();
+        storeMap.clear();
+        alias.clear();
+        x.clear();
+        var_num = 0;
+        alloca_num = 0;
+    }
 
-                	z3::expr temp = ctx.constant(var.name.c_str(), z3::to_sort(ctx, fp_sort));
-                    x.push_back(temp);
-                }
-                else if(type==INT){
-	             	z3::expr temp = ctx.bv_const(var.name.c_str(), numBits);
-                    x.push_back(temp);
-                }
-                exprMap[i] = var_num;
-                inputID++;
-                var_num++;
+    /* the symbol slot of a variable, the other types share the slot of the first FP/INT variable */
+    int LinearVarTable::slot(int ID){
+        VarType type = cfg->variableList[ID].type;
+        if(type==FP||type==INT)
+            return ID;
+        if(firstNum==-2){
+            firstNum = -1;
+            for(unsigned i=0;i<cfg->variableList.size()&&firstNum<0;i++){
+                if(cfg->variableList[i].type==FP||cfg->variableList[i].type==INT)
+                    firstNum = i;
             }
-            else if(type==FP){
-    			Z3_sort fp_sort = getFPsort(ctx, numBits);
+        }
+        assert(firstNum>=0 && "slot error: no FP/INT variable!");
+        return firstNum;
+    }
 
-                z3::expr temp = ctx.constant(var.name.c_str(), z3::to_sort(ctx, fp_sort));
-                x.push_back(temp);
-                exprMap[i] = var_num; 
-                var_num++;
+    /* the untimed symbol of a variable, created on its first use by the path */
+    void LinearVarTable::mkX(int ID){
+        Variable &var = cfg->variableList[ID];
+        z3::expr sym(ctx);
+        if(!symbols.lookup(ID, -1, var.type, var.numbits, sym)){
+            if(var.type==FP){
+                Z3_sort fp_sort = getFPsort(ctx, var.numbits);
+                sym = ctx.constant(var.name.c_str(), z3::to_sort(ctx, fp_sort));
             }
-            else if(type==INT){
-                z3::expr temp = ctx.bv_const(var.name.c_str(), numBits);
-                x.push_back(temp);
-                exprMap[i] = var_num; 
-                var_num++;
+            else{
+                sym = ctx.bv_const(var.name.c_str(), var.numbits);
             }
+            symbols.insert(ID, -1, var.type, var.numbits, sym);
         }
+        x.set(ID, sym);
+        var_num++;
     }
 
-    LinearVarTable::~LinearVarTable(){varVal.clear();alias.clear();storeMap.clear();exprMap.clear();x.clear();cfg=NULL;}
-
     void LinearVarTable::setX(int ID, int time, VarType type, unsigned numBits, z3::context &ctx){
 
-        int ID2 = exprMap[ID];
-        string newName = cfg->variableList[ID].name+"/t"+int2string(time);
-        if(type==FP){
-            Z3_sort fp_sort = getFPsort(ctx, numBits);
-                
-            x[ID2] = ctx.constant(newName.c_str(), z3::to_sort(ctx, fp_sort));           
-        }
-        else if(type==INT){
-            x[ID2] = ctx.bv_const(newName.c_str(), numBits);
+        int ID2 = slot(ID);
+        z3::expr sym(ctx);
+        if(!symbols.lookup(ID, time, type, numBits, sym)){
+            string newName = cfg->variableList[ID].name+"/t"+int2string(time);
+            if(type==FP){
+                Z3_sort fp_sort = getFPsort(ctx, numBits);
+                sym = ctx.constant(newName.c_str(), z3::to_sort(ctx, fp_sort));
+            }
+            else if(type==INT){
+                sym = ctx.bv_const(newName.c_str(), numBits);
+            }
+            else
+                assert(false && "SetX error!!!");
+            symbols.insert(ID, time, type, numBits, sym);
         }
-        else
-            assert(false && "SetX error!!!");
+        x.set(ID2, sym);
+        var_num++;
     }
 
     int LinearVarTable::alloca(){
-        storeMap[++alloca_num] = -2;
+        storeMap.set(++alloca_num, -2);
         return alloca_num;
     }
 
     void LinearVarTable::setAlias(int ID1, int ID2){
-        int count = alias.count(ID2);
-        if(count)
-            ID2 = alias[ID2];
-        alias[ID1] = ID2;
+        if(alias.count(ID2))
+            ID2 = alias.get(ID2);
+        alias.set(ID1, ID2);
     }
 
     void LinearVarTable::setAlias(Variable *v1, Variable *v2){
-        int ID1=v1->ID;
-        int ID2=v2->ID;
-        int count = alias.count(ID2);
-        if(count)
-            ID2 = alias[ID2];
-        alias[ID1] = ID2;
+        setAlias(v1->ID, v2->ID);
     }
 
     void LinearVarTable::setVal(int ID, double val){
-        varVal[ID] = val;
+        varVal.set(ID, val);
     }
 
     void LinearVarTable::store(int ID1, int ID2){
-        storeMap[ID1] = ID2;
+        storeMap.set(ID1, ID2);
     }
 
     int LinearVarTable::getNum(){
@@ -130,26 +141,23 @@ const int BitPerByte = 8;
     }
     
     z3::expr LinearVarTable::getX(int ID){
-        int count = alias.count(ID);
-        if(count)
-            ID = alias[ID];
-        int ID2 = exprMap[ID];
-        return x[ID2];
+        if(alias.count(ID))
+            ID = alias.get(ID);
+        int ID2 = slot(ID);
+        if(!x.count(ID2))
+            mkX(ID2);
+        return x.get(ID2);
     }
 
     void LinearVarTable::setX(int ID, z3::expr expr){
-        int count = alias.count(ID);
-        if(count)
-            ID = alias[ID];
-        int ID2 = exprMap[ID];
-        x[ID2] = expr;
+        if(alias.count(ID))
+            ID = alias.get(ID);
+        x.set(slot(ID), expr);
     }
 
     int LinearVarTable::load(int ID){
-        int count = storeMap.count(ID);
-        int storeID;
-        if(count){
-            storeID = storeMap[ID];
+        if(storeMap.count(ID)){
+            int storeID = storeMap.get(ID);
             if(storeID==-2){
                 errs()<<"GetLoad error1 "<<ID<<"\t"<<cfg->variableList[ID]<<"\n";
                 assert(false);
@@ -161,40 +169,20 @@ const int BitPerByte = 8;
             return -1;
         }
     }
+
     bool LinearVarTable::hasAlias(Variable *v){
-        int ID = v->ID;
-        int count = alias.count(ID);
-        if(count)
-            return true;
-        else
-            return false;
+        return alias.count(v->ID);
     }
 
     Variable* LinearVarTable::getAlias(int ID){
-        int count = alias.count(ID);
-        int aliasID;
-        if(count){
-            aliasID = alias[ID];
-        }
-        else{
-            aliasID = ID;
-        }
+        int aliasID = alias.count(ID)?alias.get(ID):ID;
         return &cfg->variableList[aliasID];
     }
 
     Variable* LinearVarTable::getAlias(Variable* var){
         if(var->type==INTNUM||var->type==FPNUM)
             return var;
-        int ID = var->ID;
-        int count = alias.count(ID);
-        int aliasID;
-        if(count){
-            aliasID = alias[ID];
-        }
-        else{
-            aliasID = ID;
-        }
-        return &cfg->variableList[aliasID];
+        return getAlias(var->ID);
     }
 
     bool LinearVarTable::getVal(Variable *var, double &v){
@@ -202,60 +190,95 @@ const int BitPerByte = 8;
             v=var->getVal();
             return true;
         }
-        int ID = var->ID;
-        int count = varVal.count(ID);
-        if(count){
-            v = varVal[ID];
-            return true;
-        }
-        else{
-            return false;
-        }
+        return getVal(var->ID, v);
     }
 
     bool LinearVarTable::getVal(int ID, double &v){
-        int count = varVal.count(ID);
-        if(count){
-            v = varVal[ID];
+        if(varVal.count(ID)){
+            v = varVal.get(ID);
             return true;
         }
         else{
             return false;
         }
     }
+
     void LinearVarTable::printAliasMap(){
         errs()<<"AliasMap:\n";
-        for(map<int,int>::iterator it=alias.begin();it!=alias.end();++it){
+        map<int, int> aliasMap = alias.toMap();
+        for(map<int,int>::iterator it=aliasMap.begin();it!=aliasMap.end();++it){
             errs()<<cfg->variableList[it->first]<<"\t\t"<<cfg->variableList[it->second]<<"\n";
         }
     }
+
     map<int, double> LinearVarTable::getValmap(){
-           return varVal;
+           return varVal.toMap();
     }
 
     map<int, int> LinearVarTable::getAliasmap(){
-           return alias;
+           return alias.toMap();
     }
 
     CFG *LinearVarTable::getCFG(){
         return cfg;
     }
 
+    void LinearVarTable::startRecord(Record &r){
+        r.allocaIn = alloca_num;
+        varVal.startRecord();
+        storeMap.startRecord();
+        alias.startRecord();
+        x.startRecord();
+    }
+
+    void LinearVarTable::stopRecord(Record &r){
+        varVal.stopRecord(r.valIn, r.valOut);
+        storeMap.stopRecord(r.storeIn, r.storeOut);
+        alias.stopRecord(r.aliasIn, r.aliasOut);
+        x.stopRecord(r.xIn, r.xOut);
+        r.allocaOut = alloca_num;
+    }
+
+    /* whether the table holds the inputs of a recorded encoding */
+    bool LinearVarTable::matches(const Record &r){
+        if(r.allocaOut!=r.allocaIn&&alloca_num!=r.allocaIn)
+            return false;
+        return varVal.matches(r.valIn)&&storeMap.matches(r.storeIn)&&alias.matches(r.aliasIn)&&x.matches(r.xIn);
+    }
+
+    void LinearVarTable::apply(const Record &r){
+        varVal.apply(r.valOut);
+        storeMap.apply(r.storeOut);
+        alias.apply(r.aliasOut);
+        x.apply(r.xOut);
+        alloca_num = r.allocaOut;
+    }
+
 /********************************class LinearVerify***********************************/
 /*******************************solution of linear problems by z3**********************************/
-LinearVerify::LinearVerify(){
+LinearVerify::LinearVerify():inc(c){
 	solverTime = 0;
+    seed = 0;
+    memoSize = 0;
     setRoundMode();
+    table = NULL;
+    reset_incremental();
 }
 
-LinearVerify::LinearVerify(DebugInfo *d, int mode){
+LinearVerify::LinearVerify(DebugInfo *d, int mode):inc(c){
     solverTime = 0;
+    seed = 0;
+    memoSize = 0;
     setRoundMode();
+    table = NULL;
+    reset_incremental();
     this->dbg = d;
     this->outMode = mode;
 }
 
 LinearVerify::~LinearVerify(){
+    delete table;
+    table = NULL;
     dbg = NULL;
     clear();
 }
@@ -293,11 +316,19 @@ bool LinearVerify::check(CFG* ha, vector<int> &path){
         clock_t start,finish;
 
         z3::expr_vector problem = encode_path(ha, path);
+        if(canceled)
+            return false;
         start = clock();
 
-        SubsetSolver csolver(c, problem, true);
-        MapSolver msolver(csolver.size());
-        bool res = analyze_unsat_core(csolver, msolver);
+        bool res;
+        if(UC_LEVEL>0&&MUS_JOBS>1)
+            res = analyze_unsat_core_parallel(problem);
+        else{
+            z3::expr_vector selectors = get_selectors(path, problem);
+            SubsetSolver csolver(c, inc, problem, selectors);
+            MapSolver msolver(csolver.size());
+            res = analyze_unsat_core(csolver, msolver);
+        }
 
         finish=clock();
 
@@ -310,6 +341,10 @@ bool LinearVerify::check(CFG* ha, vector<int> &path){
         }
     }
     catch (z3::exception ex) {
+        //the trie may hold a node whose constraints were not all asserted
+        reset_incremental();
+        if(canceled)
+            return false;
         cerr << "Error: " << ex << "\n";
         throw_error("fatal error: z3 exception");
     }
@@ -1811,11 +1846,23 @@ bool LinearVerify::get_constraint(Constraint *con, LinearVarTable *table, int ti
 
 /*encode the abstract into a linear costraint set */
 z3::expr_vector LinearVerify::encode_path(CFG* ha, vector<int> &patharray){
-    LinearVarTable *table = new LinearVarTable(c, ha);
+    //the table is kept across checks, reset only reverts the entries of the previous path
+    if(table==NULL||table->getCFG()!=ha){
+        delete table;
+        table = new LinearVarTable(c, ha);
+        memo.clear();
+        memoSize = 0;
+        reset_incremental();
+    }
+    else
+        table->reset();
+    nodeBounds.clear();
+    //every path starts in the rounding mode of the process, FESETROUND changes it on the path
+    setRoundMode();
 
     int state_num=(patharray.size()+1)/2;
-    int total_state  = ha->stateList.size()+ ha->transitionList.size();
-    vector<int> repeat(total_state,0);
+    //visits of every node of the path, sized by the path instead of the whole CFG
+    unordered_map<int,int> repeat;
     z3::expr_vector problem(c);
     
     for (int j= 0;j<state_num; j++){ 
@@ -1823,13 +1870,10 @@ z3::expr_vector LinearVerify::encode_path(CFG* ha, vector<int> &patharray){
         State* st=ha->searchState(ID);
         assert(st!=NULL);
         if(outMode==1)
-            errs()<<st->name<<":\n";
+            errs()<<symbolTable.str(st->name)<<":\n";
         //encode the previous transition guard
-        for(unsigned m=0;m<st->consList.size();m++){
-            Constraint* con = &st->consList[m];
-            bool getCon = get_constraint(con, table, repeat[ID], problem);
-            if(getCon)	index_cache.push_back(IndexPair(j,j));
-        }
+        nodeBounds.push_back(problem.size());
+        encode_node(ha->nodeTerm(ID), st->consList, repeat[ID], problem, IndexPair(j,j));
         repeat[ID]+=1;
         if(j!=state_num-1)    {
             ID = patharray[2*j+1];
@@ -1838,21 +1882,113 @@ z3::expr_vector LinearVerify::encode_path(CFG* ha, vector<int> &patharray){
             if(outMode==1)
                 errs()<<pre->name<<":\n";
             //encode the previous transition guard    
-            
-            for(unsigned m=0;m<pre->guardList.size();m++){
-                Constraint* con = &pre->guardList[m];
-                bool getCon = get_constraint(con, table, repeat[ID], problem);
-                if(getCon)	index_cache.push_back(IndexPair(j,j+1));
-            }
+            nodeBounds.push_back(problem.size());
+            encode_node(ha->nodeTerm(ID), pre->guardList, repeat[ID], problem, IndexPair(j,j+1));
             repeat[ID]+=1;
         }
     }
 
+    nodeBounds.push_back(problem.size());
     errs()<<"Encode end\n";
-    delete table;
     return problem;
 }
 
+/* drop the persistent solver and its prefix trie */
+void LinearVerify::reset_incremental(){
+    inc = z3::solver(c);
+    z3::params p(c);
+    p.set(":unsat-core",true);
+    if(seed>0)
+        p.set(":random-seed",seed);
+    inc.set(p);
+    trie.clear();
+    trieIndex.clear();
+    selectorNum = 0;
+}
+
+/* Selectors of the constraints of path in the persistent solver. The encoded nodes form a trie of
+ * path prefixes, the encoding of a node only depends on its prefix, so a node already in the trie
+ * is reused with its selectors and only the nodes behind the divergence are asserted, guarded by
+ * fresh selectors. The solver is never popped, Z3 keeps its lemmas across the paths */
+z3::expr_vector LinearVerify::get_selectors(vector<int> &path, z3::expr_vector &problem){
+    if(selectorNum+problem.size()>INC_SELECTOR_LIMIT)
+        reset_incremental();
+    z3::expr_vector selectors(c);
+    int cur = -1;
+    for(unsigned k=0;k<path.size();k++){
+        pair<int, int> key(cur, path[k]);
+        map<pair<int, int>, int>::iterator it = trieIndex.find(key);
+        if(it==trieIndex.end()){
+            PrefixNode node;
+            for(unsigned i=nodeBounds[k];i<nodeBounds[k+1];i++){
+                z3::expr sel = c.bool_const(("!a"+int2string(selectorNum++)).c_str());
+                inc.add(implies(sel, problem[i]));
+                node.selectors.push_back(sel);
+            }
+            trie.push_back(node);
+            it = trieIndex.insert(make_pair(key, (int)trie.size()-1)).first;
+        }
+        cur = it->second;
+        for(unsigned i=0;i<trie[cur].selectors.size();i++)
+            selectors.push_back(trie[cur].selectors[i]);
+    }
+    return selectors;
+}
+
+/* Encode the constraints of a node, whose hash-consed term is term, at a time frame. The encoding
+ * only depends on the term, the entries of the variable table it reads and the rounding mode, so
+ * it is recorded once and replayed on a later path which reaches the node, or another node with
+ * the same constraints, with the same inputs, without lowering the constraints again.
+ * The memo is dropped once it holds MEMO_LIMIT encodings */
+void LinearVerify::encode_node(unsigned term, vector<Constraint> &consList, int time, z3::expr_vector &problem, IndexPair index){
+    if(outMode!=0){
+        for(unsigned m=0;m<consList.size();m++){
+            if(get_constraint(&consList[m], table, time, problem))
+                index_cache.push_back(index);
+        }
+        return;
+    }
+
+    if(memoSize>=MEMO_LIMIT){
+        memo.clear();
+        memoSize = 0;
+    }
+    vector<EncodeMemo> &memos = memo[make_pair(term, time)];
+    for(unsigned i=0;i<memos.size();i++){
+        if(memos[i].roundIn==roundModeNo&&table->matches(memos[i].table)){
+            table->apply(memos[i].table);
+            roundModeNo = memos[i].roundOut;
+            for(unsigned m=0;m<consList.size();m++)
+                dbg->getConsInfo(&consList[m]);
+            for(unsigned k=0;k<memos[i].exprs.size();k++)
+                problem.push_back(memos[i].exprs[k]);
+            for(unsigned k=0;k<memos[i].cons;k++)
+                index_cache.push_back(index);
+            return;
+        }
+    }
+
+    EncodeMemo m;
+    unsigned start = problem.size();
+    m.cons = 0;
+    m.roundIn = roundModeNo;
+    table->startRecord(m.table);
+    for(unsigned k=0;k<consList.size();k++){
+        if(get_constraint(&consList[k], table, time, problem)){
+            index_cache.push_back(index);
+            m.cons++;
+        }
+    }
+    table->stopRecord(m.table);
+    m.roundOut = roundModeNo;
+    for(unsigned k=start;k<problem.size();k++)
+        m.exprs.push_back(problem[k]);
+    if(memos.size()<MEMO_VARIANTS){
+        memos.push_back(m);
+        memoSize++;
+    }
+}
+
 /* analyze the unsat core to extract the infeasible path segment */
 bool LinearVerify::analyze_unsat_core(SubsetSolver& csolver, MapSolver& msolver){
 
@@ -1868,19 +2004,12 @@ bool LinearVerify::analyze_unsat_core(SubsetSolver& csolver, MapSolver& msolver)
             vector<int> MUS = csolver.shrink(seed);
         //printVector(MUS);
         //errs()<<"\n";
-            int from = INT_MAX, to = 0;
-            if(VERBOSE_LEVEL>2) printf("MUS:\n");
-            for(unsigned i=0;i<MUS.size();i++){
-                if(VERBOSE_LEVEL>2)
+            if(VERBOSE_LEVEL>2){
+                printf("MUS:\n");
+                for(unsigned i=0;i<MUS.size();i++)
                      cout<<csolver.get_constraint(MUS[i])<<"\n";
-                int start = index_cache[MUS[i]].start;
-                int end   = index_cache[MUS[i]].end;                                                                
-                if(from>start)
-                    from = start;
-                if(to<end)
-                    to = end;
             }
-            add_IIS(IndexPair(from,to));
+            add_IIS(mus_index(MUS));
             if(UC_LEVEL == 0) break;
             msolver.block_up(MUS);
         }
@@ -1894,6 +2023,29 @@ bool LinearVerify::analyze_unsat_core(SubsetSolver& csolver, MapSolver& msolver)
 }
 
 
+/* enumerate the MUSes on MUS_JOBS workers, see parallel_mus */
+bool LinearVerify::analyze_unsat_core_parallel(z3::expr_vector &problem){
+    vector<vector<int> > muses;
+    bool res = parallel_mus(c, problem, MUS_JOBS, MUS_LIMIT, muses);
+    for(unsigned i=0;i<muses.size();i++)
+        add_IIS(mus_index(muses[i]));
+    return res;
+}
+
+/* the path segment covered by the constraints of a MUS */
+IndexPair LinearVerify::mus_index(vector<int> &MUS){
+    int from = INT_MAX, to = 0;
+    for(unsigned i=0;i<MUS.size();i++){
+        int start = index_cache[MUS[i]].start;
+        int end   = index_cache[MUS[i]].end;
+        if(from>start)
+            from = start;
+        if(to<end)
+            to = end;
+    }
+    return IndexPair(from,to);
+}
+
 /* add unsat core into cache */
 void LinearVerify::add_IIS(IndexPair index){
 	errs()<<"IIS:\t";
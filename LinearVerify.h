@@ -10,23 +10,45 @@
 #include "MUSSAnalyzer.h"
 #include "math.h"
 #include "DebugInfo.h"
+#include "TrailMap.h"
+#include "SymbolCache.h"
 #include <cfenv>
 
+//z3 terms are hash-consed, equal terms share their ast
+struct SameExpr{
+    bool operator()(const z3::expr &a, const z3::expr &b) const{return (Z3_ast)a==(Z3_ast)b;}
+};
 
 class LinearVarTable{
 private:
     int var_num;
     int alloca_num;
-    map<int, double> varVal;
-    map<int, int>storeMap;
-    map<int, int> alias;
-    vector<z3::expr> x;
-    map<int, int> exprMap;
+    int firstNum;
+    TrailMap<double> varVal;
+    TrailMap<int> storeMap;
+    TrailMap<int> alias;
+    TrailMap<z3::expr, SameExpr> x;
+    SymbolCache<z3::expr> symbols;
+    z3::context &ctx;
     CFG *cfg;
+    int slot(int ID);
+    void mkX(int ID);
 
 public:
     LinearVarTable(z3::context &ctx, CFG *ha);
     ~LinearVarTable();
+    void reset();
+    //inputs and outputs of the encoding of one node, see TrailMap
+    struct Record{
+        vector<TrailMap<double>::Entry> valIn, valOut;
+        vector<TrailMap<int>::Entry> storeIn, storeOut, aliasIn, aliasOut;
+        vector<TrailMap<z3::expr, SameExpr>::Entry> xIn, xOut;
+        int allocaIn, allocaOut;
+    };
+    void startRecord(Record &r);
+    void stopRecord(Record &r);
+    bool matches(const Record &r);
+    void apply(const Record &r);
     void setX(int ID, int time, VarType type, unsigned numBits, z3::context &ctx);
     int alloca();
     void setAlias(int ID1, int ID2);
@@ -48,12 +70,39 @@ public:
     CFG *getCFG();
 };
 
+/* a node of the prefix trie of the persistent solver, with the selectors of its constraints */
+class PrefixNode{
+public:
+    vector<z3::expr> selectors;
+};
+
+/* memoised encoding of the constraints of a node at a time frame */
+class EncodeMemo{
+public:
+    LinearVarTable::Record table;
+    vector<z3::expr> exprs;
+    unsigned cons;
+    //rounding mode before and after the node, FESETROUND/FEGETROUND and the FP operations use it
+    int roundIn;
+    int roundOut;
+};
+
 class LinearVerify: public Verify{
     z3::context c; 
+    //persistent solver of the current target, see get_selectors
+    z3::solver inc;
+    vector<PrefixNode> trie;
+    map<pair<int, int>, int> trieIndex;
+    unsigned selectorNum;
+    vector<unsigned> nodeBounds;
     int roundModeNo;
+    unsigned seed;
     int outMode;
     DebugInfo *dbg;
     double solverTime;
+    LinearVarTable *table;
+    map<pair<unsigned, int>, vector<EncodeMemo> > memo;     //by (term of the node, time frame)
+    unsigned memoSize;
 
     z3::expr_vector encode_path(CFG* ha, vector<int> &path);
     z3::expr getExpr(Variable *v, bool &treat, double &val, LinearVarTable *table);
@@ -73,7 +122,12 @@ class LinearVerify: public Verify{
     z3::expr mk_function_expr(Variable *lv, ParaVariable rpv, LinearVarTable *table, int time);
     ///////////////////////////////////////////
     bool get_constraint(Constraint *con, LinearVarTable *table, int time, z3::expr_vector &p);
+    void encode_node(unsigned term, vector<Constraint> &consList, int time, z3::expr_vector &problem, IndexPair index);
     bool analyze_unsat_core(SubsetSolver& csolver, MapSolver& msolver);
+    bool analyze_unsat_core_parallel(z3::expr_vector &problem);
+    void reset_incremental();
+    z3::expr_vector get_selectors(vector<int> &path, z3::expr_vector &problem);
+    IndexPair mus_index(vector<int> &MUS);
     void add_IIS(IndexPair index);
     std::vector<IndexPair> index_cache; 
     std::vector<IndexPair> core_index;     
@@ -87,6 +141,10 @@ public:
     bool check(CFG* ha, vector<int> &path);
     vector<IndexPair> get_core_index(){return core_index;}
     double getTime(){return solverTime;}
+    void interrupt(){canceled=true;c.interrupt();}
+    void newTarget(){reset_incremental();}
+    //random seed of Z3, the instances of a portfolio differ by it
+    void setSeed(unsigned s){seed=s;reset_incremental();}
     void print_sol(CFG* cfg);
 };
 
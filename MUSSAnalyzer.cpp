@@ -1,37 +1,41 @@
+
 #include "MUSSAnalyzer.h"
+#include <thread>
+#include <mutex>
+#include <set>
+#include <algorithm>
+#include <climits>
 using namespace z3;
 using namespace std;
 
 
-static void remove(vector<int>& seed, int c){
-    for(vector<int>::iterator it=seed.begin();it!=seed.end();++it){
-		if(*it == c){
-			seed.erase(it);
-            break;
-		}
-    }
-}
-
 int SubsetSolver::get_id(expr x){
-        func_decl v=x.decl();
-        return atoi(v.name().str().c_str());
+        map<unsigned, int>::iterator it = selectorIndex.find(Z3_get_ast_id(c, x));
+        assert(it!=selectorIndex.end() && "get_id error: not a selector!");
+        return it->second;
 }
 
-SubsetSolver::SubsetSolver(context& _c, expr_vector _constraints, bool _unsat_core):c(_c),s(_c),constraints(_constraints),unsat_core(_unsat_core){
-        n = constraints.size();
+SubsetSolver::SubsetSolver(context& _c, expr_vector _constraints, bool _unsat_core):n(_constraints.size()),unsat_core(_unsat_core),c(_c),s(_c),constraints(_constraints),selectors(_c){
         params p(c);
         p.set(":unsat-core",unsat_core);
         p.set(":auto-config",!unsat_core);
         s.set(p);
+        for(unsigned i=0;i<n;i++){
+            expr v = c.bool_const(("!s"+int2string(i)).c_str());
+            selectors.push_back(v);
+            selectorIndex[Z3_get_ast_id(c, v)] = i;
+            s.add(implies(v, constraints[i]));
+        }
+}
+
+/* subsets of the constraints of a solver which already holds selectors[i] => constraints[i] */
+SubsetSolver::SubsetSolver(context& _c, solver &_s, expr_vector _constraints, expr_vector _selectors):n(_constraints.size()),unsat_core(true),c(_c),s(_s),constraints(_constraints),selectors(_selectors){
         for(unsigned i=0;i<n;i++)
-            s.add(implies(c_var(i), constraints[i]));
+            selectorIndex[Z3_get_ast_id(c, selectors[i])] = i;
 }
 
 expr SubsetSolver::c_var(int i){
-        char ch[256];
-        sprintf(ch,"%i",i);
-        expr v=c.bool_const(ch);
-        return v;
+        return selectors[i];
 }
 
 expr SubsetSolver::get_constraint(int i){
@@ -44,15 +48,23 @@ void SubsetSolver::printVector(vector<int> &seed){
     cerr<<endl;
 }
 
-bool SubsetSolver::check_subset(vector<int> seed){
+check_result SubsetSolver::check(vector<int> &seed){
         expr_vector assumptions=to_c_lits(seed);
-//        cout<<"assumptions: "<<assumptions<<endl;
-        switch(s.check(assumptions)){
-            case sat:cerr<<"sat"<<endl;
-            case unsat:cerr<<"unsat"<<endl;
-            default:cerr<<"unknown"<<endl;
-        }
-        return (s.check(assumptions) == sat);
+        return s.check(assumptions);
+}
+
+/* bound the time of the following queries, a query out of budget answers unknown */
+void SubsetSolver::setBudget(unsigned ms){
+        if(ms==0)
+            return;
+        params p(c);
+        p.set(":unsat-core",unsat_core);
+        p.set(":timeout",ms);
+        s.set(p);
+}
+
+bool SubsetSolver::check_subset(vector<int> seed){
+        return check(seed) == sat;
 }
 
 expr_vector SubsetSolver::to_c_lits(vector<int> seed){
@@ -65,80 +77,178 @@ expr_vector SubsetSolver::to_c_lits(vector<int> seed){
 vector<int> SubsetSolver::seed_from_core(){
         vector<int> seed;
         expr_vector core = s.unsat_core();
-        cerr<<"unsat_core:\t"<<core<<endl;
         for(unsigned i=0;i<core.size();i++){
             seed.push_back(get_id(core[i]));
         }
-        printVector(seed);
         return seed;
 }
 
+/* Minimise the core of the last unsat check of seed. The core is first trimmed by checking
+ * it again until it stops shrinking, then every constraint is tried for deletion. A deletion
+ * which keeps the set unsat also drops every constraint outside the new core, a deletion
+ * which makes it sat (or runs out of budget) marks the constraint as critical */
 vector<int> SubsetSolver::shrink(vector<int> seed){
         vector<int> core = seed_from_core();
-        for(unsigned i=0;i<seed.size();i++){
-            remove(core, seed[i]);
-            // printVector(core);
-            expr_vector core_exprs = to_c_lits(core);
-            if(s.check(core_exprs) != unsat)
-				core.push_back(seed[i]);
+        setBudget(MUS_BUDGET);
+        for(int round=0;round<3;round++){
+            if(check(core)!=unsat)
+                break;
+            vector<int> trimmed = seed_from_core();
+            if(trimmed.size()>=core.size())
+                break;
+            core = trimmed;
+        }
+
+        vector<int> critical;
+        vector<char> inCore(n, 0);
+        for(unsigned i=0;i<core.size();i++)
+            inCore[core[i]] = 1;
+        while(!core.empty()){
+            int x = core.back();
+            core.pop_back();
+            if(!inCore[x])
+                continue;
+            vector<int> candidate(critical);
+            for(unsigned i=0;i<core.size();i++){
+                if(inCore[core[i]])
+                    candidate.push_back(core[i]);
+            }
+            if(check(candidate)==unsat){
+                inCore[x] = 0;
+                vector<char> inNew(n, 0);
+                vector<int> newCore = seed_from_core();
+                for(unsigned i=0;i<newCore.size();i++)
+                    inNew[newCore[i]] = 1;
+                for(unsigned i=0;i<core.size();i++){
+                    if(!inNew[core[i]])
+                        inCore[core[i]] = 0;
+                }
+            }
+            else
+                critical.push_back(x);
         }
-        return core;
+        //the solver may be kept for the next path, lift the budget again
+        if(MUS_BUDGET)
+            setBudget(UINT_MAX);
+        return critical;
 }
 
-MapSolver::MapSolver(int _n):s(c),n(_n){
-        for(int i=0;i<n;i++)
-          all_n.push_back(i);
+MapSolver::MapSolver(int _n):n(_n){
+        for(int i=0;i<n;i++){
+            s.newVar();
+            //the decision literal of a variable is positive, seeds grow towards all constraints
+            s.setPolarity(i, Minisat::l_False);
+        }
 }
 
 vector<int> MapSolver::next_seed(){
         vector<int> seed;
-        if(s.check() == sat){
-                seed = all_n;
-                model m=s.get_model();
-                for(unsigned i=0;i<m.size();i++){
-                        func_decl v=m[i];
-                        expr value=m.get_const_interp(v);
-                        if(value.is_bool() && eq(value,c.bool_val(false))){
-                                remove(seed,atoi(v.name().str().c_str()));
-                        }
-                }
+        if(s.solve()){
+            for(int i=0;i<n;i++){
+                if(s.modelValue(i)!=Minisat::l_False)
+                    seed.push_back(i);
+            }
         }
         return seed;
 }
 
 void MapSolver::block_up(vector<int> frompoint){
-        expr exp(c);
-        for(unsigned i=0;i<frompoint.size();i++){
-                expr exp1 = !c.bool_const(int2string(frompoint[i]).c_str());
-                if(i == 0)
-                  exp=exp1;
-                else
-                  exp=exp || exp1;
-        }
+        Minisat::vec<Minisat::Lit> lits;
+        for(unsigned i=0;i<frompoint.size();i++)
+            lits.push(~Minisat::mkLit(frompoint[i]));
         if(frompoint.size()!=0)
-                s.add(exp);
+            s.addClause(lits);
 }
 
 void MapSolver::block_down(vector<int> frompoint){
-        expr exp(c);
-        bool initial = true;
-        for(unsigned i=0;i<all_n.size();i++){
-                unsigned j;
-                for(j=0;j<frompoint.size();j++){
-                        if(all_n[i] == frompoint[j])
-                          break;
-                }
-                if(j == frompoint.size()){
-                        expr exp1 = c.bool_const(int2string(all_n[i]).c_str());
-                        if(initial){
-                                exp = exp1;
-                                initial = false;
+        vector<char> in(n, 0);
+        for(unsigned i=0;i<frompoint.size();i++)
+            in[frompoint[i]] = 1;
+        Minisat::vec<Minisat::Lit> lits;
+        for(int i=0;i<n;i++){
+            if(!in[i])
+                lits.push(Minisat::mkLit(i));
+        }
+        if(lits.size()!=0)
+            s.addClause(lits);
+}
+
+/* Enumerate up to limit MUSes of constraints on jobs workers. The workers share the map solver,
+ * a worker takes the next seed under the lock, checks and shrinks it in its own context and
+ * publishes the MUS (block_up) or the satisfiable seed (block_down). Two workers may draw the
+ * same seed before either publishes, the duplicate MUS is dropped.
+ * Returns false iff the whole constraint set is satisfiable */
+bool parallel_mus(context &c, expr_vector constraints, int jobs, int limit, vector<vector<int> > &muses){
+        unsigned n = constraints.size();
+        MapSolver msolver(n);
+        mutex lock;
+        bool feasible = false, stop = false;
+        string error;
+        set<vector<int> > found;
+
+        //z3 contexts are not thread safe, every worker solves a copy of the constraints in its own context
+        vector<context*> ctxs;
+        vector<expr_vector*> copies;
+        for(int w=0;w<jobs;w++){
+            context *ctx = new context();
+            expr_vector *copy = new expr_vector(*ctx);
+            for(unsigned i=0;i<n;i++)
+                copy->push_back(expr(*ctx, Z3_translate(c, constraints[i], *ctx)));
+            ctxs.push_back(ctx);
+            copies.push_back(copy);
+        }
+
+        vector<thread> workers;
+        for(int w=0;w<jobs;w++){
+            workers.push_back(thread([&, w](){
+                try{
+                    SubsetSolver csolver(*ctxs[w], *copies[w], true);
+                    while(true){
+                        vector<int> seed;
+                        {
+                            lock_guard<mutex> guard(lock);
+                            if(stop||(int)found.size()>=limit)
+                                return;
+                            seed = msolver.next_seed();
+                            if(seed.size()==0){
+                                stop = true;
+                                return;
+                            }
                         }
-                        else
-                                exp = exp||exp1;
+                        if(!csolver.check_subset(seed)){
+                            vector<int> MUS = csolver.shrink(seed);
+                            std::sort(MUS.begin(), MUS.end());
+                            lock_guard<mutex> guard(lock);
+                            msolver.block_up(MUS);
+                            if(found.insert(MUS).second)
+                                muses.push_back(MUS);
+                        }
+                        else{
+                            lock_guard<mutex> guard(lock);
+                            if(seed.size()==n){
+                                feasible = true;
+                                stop = true;
+                                return;
+                            }
+                            msolver.block_down(seed);
+                        }
+                    }
                 }
+                catch(z3::exception &ex){
+                    lock_guard<mutex> guard(lock);
+                    error = ex.msg();
+                    stop = true;
+                }
+            }));
         }
-        if(!initial){
-                s.add(exp);
+        for(unsigned w=0;w<workers.size();w++)
+            workers[w].join();
+
+        for(int w=0;w<jobs;w++){
+            delete copies[w];
+            delete ctxs[w];
         }
+        if(error!="")
+            throw z3::exception(error.c_str());
+        return !feasible;
 }
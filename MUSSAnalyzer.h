@@ -9,20 +9,33 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <vector>
+#include <map>
 #include "z3++.h"
+#include "minisat/core/Solver.h"
 #include "general.h"
 
 extern int UC_LEVEL;
+//time budget of a single minimisation query in ms, 0 for none
+extern unsigned MUS_BUDGET;
+//workers enumerating the MUSes when UC_LEVEL>0
+extern int MUS_JOBS;
 #define MUS_LIMIT 50
 
+/* Checks subsets of the constraints through one selector literal per constraint.
+ * Selectors are kept in a vector and mapped back from the unsat core by their ast id */
 class SubsetSolver{        
         unsigned n;
         bool unsat_core;
         z3::context& c;
         z3::solver s;
         z3::expr_vector constraints;
+        z3::expr_vector selectors;
+        std::map<unsigned, int> selectorIndex;
+        z3::check_result check(std::vector<int> &seed);
+        void setBudget(unsigned ms);
 public:
         SubsetSolver(z3::context& _c, z3::expr_vector _constraints ,bool _unsat_core);
+        SubsetSolver(z3::context& _c, z3::solver &_s, z3::expr_vector _constraints, z3::expr_vector _selectors);
         z3::expr c_var(int i);
         bool check_subset(std::vector<int> seed);
         z3::expr_vector to_c_lits(std::vector<int> seed);
@@ -34,11 +47,10 @@ public:
         unsigned size(){return n;}
 };
 
+/* The map of the explored subsets: variable i selects constraint i */
 class MapSolver{
-        z3::context c;
-        z3::solver s;
+        Minisat::Solver s;
         int n;
-        std::vector<int> all_n;
 public:
         MapSolver(int n);
         std::vector<int> next_seed();
@@ -46,10 +58,10 @@ public:
         void block_down(std::vector<int> frompoint);
 };
 
+bool parallel_mus(z3::context &c, z3::expr_vector constraints, int jobs, int limit, std::vector<std::vector<int> > &muses);
+
 
         
         
 
 #endif
-
-
@@ -2,97 +2,97 @@
 #include "NonlinearVerify.h"
 #include "time.h"
 #include "float.h"
+#include <mutex>
 using namespace std;
 
+//dReal keeps process-wide state behind dreal_init(), serialize context creation across workers
+static mutex drealInitLock;
+
 /***********************  Class NonlinearVarTable  *********************/
 
-    NonlinearVarTable::NonlinearVarTable(dreal_context &c, CFG *ha):ctx(c), cfg(ha){
-        unsigned inputID=0;
+    NonlinearVarTable::NonlinearVarTable(dreal_context &c, CFG *ha):varVal(0), storeMap(0), alias(0), x(NULL), ctx(c){
+        cfg = ha;
         var_num = 0;
         alloca_num = 0;
-        // for(int i=0; i<cfg->mainInput.size();i++)
-        //     errs()<<"NonlinearVarTable initial "<<cfg->mainInput[i]<<"\t"<<cfg->variableList[cfg->mainInput[i]].name<<"\n";
-        for(unsigned i=0;i<cfg->variableList.size();i++)
-        {
-
-            Variable var =  cfg->variableList[i];
-            VarType type = var.type;
-
-            if(inputID<cfg->mainInput.size()&&cfg->mainInput[inputID]==i){
-
-                if(type==FP)
-                    // x.push_back(dreal_mk_real_var(ctx, var.name.c_str(), -1000.0, 1000.0));
-                    x.push_back(dreal_mk_unbounded_real_var(ctx, var.name.c_str()));
-                else if(type==INT)
-                    // x.push_back(dreal_mk_int_var(ctx, var.name.c_str(), -1000.0, 1000.0));
-                    x.push_back(dreal_mk_unbounded_int_var(ctx, var.name.c_str()));
-                exprMap[i] = var_num;
-//                double const x_lb = dreal_get_lb(ctx, x[var_num]);
-//                double const x_ub = dreal_get_ub(ctx, x[var_num]);
-//                errs()<<var.name<<" = ["<<x_lb<<", "<<x_ub<<"]\n";
-                inputID++;
-                var_num++;
-            }
-            else if(type==FP){
-                x.push_back(dreal_mk_unbounded_real_var(ctx, var.name.c_str()));
-                exprMap[i] = var_num; 
-                var_num++;
-            }
-            else if(type==INT){
-                x.push_back(dreal_mk_unbounded_int_var(ctx, var.name.c_str()));
-                exprMap[i] = var_num; 
-                var_num++;
-            }
-
-        }
+        firstNum = -2;
     }
 
-    NonlinearVarTable::~NonlinearVarTable(){
+    NonlinearVarTable::~NonlinearVarTable(){cfg=NULL;}
+
+    /* forget the path encoded before, only the entries it touched are reverted */
+    void NonlinearVarTable::reset(){
         varVal.clear();
-        alias.clear();
         storeMap.clear();
-        exprMap.clear();
+        alias.clear();
         x.clear();
-        cfg=NULL;
+        var_num = 0;
+        alloca_num = 0;
     }
 
+    /* the symbol slot of a variable, the other types share the slot of the first FP/INT variable */
+    int NonlinearVarTable::slot(int ID){
+        VarType type = cfg->variableList[ID].type;
+        if(type==FP||type==INT)
+            return ID;
+        if(firstNum==-2){
+            firstNum = -1;
+            for(unsigned i=0;i<cfg->variableList.size()&&firstNum<0;i++){
+                if(cfg->variableList[i].type==FP||cfg->variableList[i].type==INT)
+                    firstNum = i;
+            }
+        }
+        assert(firstNum>=0 && "slot error: no FP/INT variable!");
+        return firstNum;
+    }
+
+    /* the untimed symbol of a variable, created on its first use by the path */
+    void NonlinearVarTable::mkX(int ID){
+        Variable &var = cfg->variableList[ID];
+        if(var.type==FP){
+            x.set(ID, dreal_mk_unbounded_real_var(ctx, var.name.c_str()));
+        }
+        else{
+            x.set(ID, dreal_mk_unbounded_int_var(ctx, var.name.c_str()));
+        }
+        var_num++;
+    }
 
     void NonlinearVarTable::setX(int ID, int time, VarType type){
-        int ID2 = exprMap[ID];
-        if(type==FP)
-            x[ID2] = dreal_mk_unbounded_real_var(ctx, (cfg->variableList[ID].name+"/t"+int2string(time)).c_str());
-        else if(type==INT)
-            x[ID2] = dreal_mk_unbounded_int_var(ctx, (cfg->variableList[ID].name+"/t"+int2string(time)).c_str());
+
+        int ID2 = slot(ID);
+        string newName = cfg->variableList[ID].name+"/t"+int2string(time);
+        if(type==FP){
+            x.set(ID2, dreal_mk_unbounded_real_var(ctx, newName.c_str()));
+        }
+        else if(type==INT){
+            x.set(ID2, dreal_mk_unbounded_int_var(ctx, newName.c_str()));
+        }
         else
-            assert(false && "SetX error 10086!!");
+            assert(false && "SetX error!!!");
+        var_num++;
     }
+
     int NonlinearVarTable::alloca(){
-        storeMap[++alloca_num] = -2;
+        storeMap.set(++alloca_num, -2);
         return alloca_num;
     }
+
     void NonlinearVarTable::setAlias(int ID1, int ID2){
-        int count = alias.count(ID2);
-        if(count)
-            ID2 = alias[ID2];
-        alias[ID1] = ID2;
-        // errs()<<"setAlias: ";
-        // errs()<<cfg->variableList[ID1]<<"\t\t"<<cfg->variableList[ID2]<<"\n";
+        if(alias.count(ID2))
+            ID2 = alias.get(ID2);
+        alias.set(ID1, ID2);
     }
+
     void NonlinearVarTable::setAlias(Variable *v1, Variable *v2){
-        int ID1=v1->ID;
-        int ID2=v2->ID;
-        int count = alias.count(ID2);
-        if(count)
-            ID2 = alias[ID2];
-        alias[ID1] = ID2;
-        // errs()<<"setAlias: ";
-        // errs()<<cfg->variableList[ID1]<<"\t\t"<<cfg->variableList[ID2]<<"\n";
+        setAlias(v1->ID, v2->ID);
     }
+
     void NonlinearVarTable::setVal(int ID, double val){
-        varVal[ID] = val;
+        varVal.set(ID, val);
     }
+
     void NonlinearVarTable::store(int ID1, int ID2){
-        storeMap[ID1] = ID2;
+        storeMap.set(ID1, ID2);
     }
 
     int NonlinearVarTable::getNum(){
@@ -100,26 +100,23 @@ using namespace std;
     }
     
     dreal_expr NonlinearVarTable::getX(int ID){
-        int count = alias.count(ID);
-        if(count)
-            ID = alias[ID];
-        int ID2 = exprMap[ID];
-        return x[ID2];
+        if(alias.count(ID))
+            ID = alias.get(ID);
+        int ID2 = slot(ID);
+        if(!x.count(ID2))
+            mkX(ID2);
+        return x.get(ID2);
     }
 
     void NonlinearVarTable::setX(int ID, dreal_expr expr){
-    	int count = alias.count(ID);
-        if(count)
-            ID = alias[ID];
-        int ID2 = exprMap[ID];
-        x[ID2] = expr;
+        if(alias.count(ID))
+            ID = alias.get(ID);
+        x.set(slot(ID), expr);
     }
 
     int NonlinearVarTable::load(int ID){
-        int count = storeMap.count(ID);
-        int storeID;
-        if(count){
-            storeID = storeMap[ID];
+        if(storeMap.count(ID)){
+            int storeID = storeMap.get(ID);
             if(storeID==-2){
                 errs()<<"GetLoad error1 "<<ID<<"\t"<<cfg->variableList[ID]<<"\n";
                 assert(false);
@@ -131,94 +128,96 @@ using namespace std;
             return -1;
         }
     }
+
     bool NonlinearVarTable::hasAlias(Variable *v){
-        int ID = v->ID;
-        int count = alias.count(ID);
-        if(count)
-            return true;
-        else
-            return false;
+        return alias.count(v->ID);
     }
 
     Variable* NonlinearVarTable::getAlias(int ID){
-        int count = alias.count(ID);
-        int aliasID;
-        if(count){
-            aliasID = alias[ID];
-        }
-        else{
-            aliasID = ID;
-        }
+        int aliasID = alias.count(ID)?alias.get(ID):ID;
         return &cfg->variableList[aliasID];
     }
 
     Variable* NonlinearVarTable::getAlias(Variable* var){
         if(var->type==INTNUM||var->type==FPNUM)
             return var;
-        int ID = var->ID;
-        int count = alias.count(ID);
-        int aliasID;
-        if(count){
-            aliasID = alias[ID];
-        }
-        else{
-            aliasID = ID;
-        }
-        return &cfg->variableList[aliasID];
+        return getAlias(var->ID);
     }
+
     bool NonlinearVarTable::getVal(Variable *var, double &v){
         if(var->type==INTNUM||var->type==FPNUM){
             v=var->getVal();
             return true;
         }
-        int ID = var->ID;
-        int count = varVal.count(ID);
-        if(count){
-            v = varVal[ID];
-            return true;
-        }
-        else{
-            return false;
-        }
+        return getVal(var->ID, v);
     }
+
     bool NonlinearVarTable::getVal(int ID, double &v){
-        int count = varVal.count(ID);
-        if(count){
-            v = varVal[ID];
+        if(varVal.count(ID)){
+            v = varVal.get(ID);
             return true;
         }
         else{
             return false;
         }
     }
+
     void NonlinearVarTable::printAliasMap(){
-    	errs()<<"AliasMap:\n";
-        for(map<int,int>::iterator it=alias.begin();it!=alias.end();++it){
+        errs()<<"AliasMap:\n";
+        map<int, int> aliasMap = alias.toMap();
+        for(map<int,int>::iterator it=aliasMap.begin();it!=aliasMap.end();++it){
             errs()<<cfg->variableList[it->first]<<"\t\t"<<cfg->variableList[it->second]<<"\n";
         }
     }
+
     map<int, double> NonlinearVarTable::getValmap(){
-           return varVal;
+           return varVal.toMap();
     }
+
     map<int, int> NonlinearVarTable::getAliasmap(){
-           return alias;
+           return alias.toMap();
     }
+
     CFG *NonlinearVarTable::getCFG(){
         return cfg;
     }
 
+    /* position of the table to come back to when a solver scope is popped */
+    NonlinearVarTable::Mark NonlinearVarTable::mark(){
+        Mark m;
+        m.varVal = varVal.mark();
+        m.storeMap = storeMap.mark();
+        m.alias = alias.mark();
+        m.x = x.mark();
+        m.alloca_num = alloca_num;
+        m.var_num = var_num;
+        return m;
+    }
+
+    void NonlinearVarTable::undo(const Mark &m){
+        varVal.undo(m.varVal);
+        storeMap.undo(m.storeMap);
+        alias.undo(m.alias);
+        x.undo(m.x);
+        alloca_num = m.alloca_num;
+        var_num = m.var_num;
+    }
+
 
 /****************** Class NonlinearVerify ******************/
 
 /***********************************check with dReal*********************************************/
 NonlinearVerify::NonlinearVerify(){
+    lock_guard<mutex> guard(drealInitLock);
     dreal_init();
     ctx = s.get_ctx();
     table=NULL;
+    incremental=false;
     solverTime=0;
 }
 
 NonlinearVerify::NonlinearVerify(double pre, DebugInfo *d, int mode){
+    lock_guard<mutex> guard(drealInitLock);
     dreal_init();
     ctx = s.get_ctx();
     table=NULL;
@@ -226,6 +225,7 @@ NonlinearVerify::NonlinearVerify(double pre, DebugInfo *d, int mode){
     dreal_set_precision(ctx, pre);
     this->dbg = d;
     this->outMode = mode;
+    incremental=false;
     solverTime=0;
 } 
 
@@ -270,6 +270,76 @@ bool NonlinearVerify::check(CFG* ha, vector<int> &path)
     return false;
 }
 
+/* Check a path sharing a prefix with the previously checked one, as produced by the DFS.
+ * The nodes behind the common prefix are popped, only the new nodes are encoded */
+bool NonlinearVerify::check_incremental(CFG* ha, vector<int> &path)
+{
+    if(!incremental){
+        reset();
+        table = new NonlinearVarTable(ctx, ha);
+        repeat.clear();
+        incremental = true;
+    }
+    index_cache.clear();
+    core_index.clear();
+
+    if(outMode==1)
+        printPath(ha, path);
+
+    unsigned common=0;
+    while(common<encoded.size()&&common<path.size()&&encoded[common]==path[common])
+        common++;
+    while(encoded.size()>common)
+        pop_node();
+    for(unsigned i=encoded.size();i<path.size();i++)
+        push_node(ha, path[i], i%2==1);
+
+    int state_num=(path.size()+1)/2;
+    clock_t start,finish;
+    start = clock();
+    bool res = analyze_unsat_core(state_num-1);
+    finish=clock();
+    solverTime = 1000*(double)(finish-start)/CLOCKS_PER_SEC;
+
+    if(outMode==1)
+        cerr<<(res?"dreal_result is sat\n\n\n":"dreal_result is unsat\n\n\n");
+    if(res)
+        print_sol(ha);
+    return res;
+}
+
+/* open a solver scope and encode one node, the variable table is marked to be restored by pop_node */
+void NonlinearVerify::push_node(CFG* ha, int ID, bool isTransition){
+    marks.push_back(table->mark());
+    encoded.push_back(ID);
+    dreal_push(ctx);
+    if(isTransition){
+        Transition* tr=ha->searchTransition(ID);
+        assert(tr!=NULL);
+        if(outMode==1)
+            cerr<<tr->name<<":"<<endl;
+        get_constraint(tr->guardList, table, repeat[ID], true);
+    }
+    else{
+        State* st=ha->searchState(ID);
+        assert(st!=NULL);
+        if(outMode==1)
+            cerr<<symbolTable.str(st->name)<<":"<<endl;
+        get_constraint(st->consList, table, repeat[ID], false);
+    }
+    repeat[ID]+=1;
+}
+
+void NonlinearVerify::pop_node(){
+    dreal_pop(ctx);
+    unordered_map<int,int>::iterator it = repeat.find(encoded.back());
+    if(--it->second==0)
+        repeat.erase(it);
+    encoded.pop_back();
+    table->undo(marks.back());
+    marks.pop_back();
+}
+
 void NonlinearVerify::print_sol(CFG* cfg) {
     // vector<unsigned> &x = cfg->mainInput;
     // for(unsigned i=0;i<x.size();i++){
@@ -2152,8 +2222,8 @@ void NonlinearVerify::encode_path(CFG* ha, vector<int> &patharray)
         state_num = (patharray.size()+1)/2;
     else
         state_num = patharray.size()/2;
-    int total_state  = ha->stateList.size()+ ha->transitionList.size();
-    vector<int> repeat(total_state,0);
+    //visits of every node of the path, sized by the path instead of the whole CFG
+    unordered_map<int,int> repeat;
     
     for (int j= 0;j<state_num; j++)
     {    
@@ -2161,7 +2231,7 @@ void NonlinearVerify::encode_path(CFG* ha, vector<int> &patharray)
         State* st=ha->searchState(ID);
         assert(st!=NULL);
         if(outMode==1)
-            cerr<<st->name<<":"<<endl;
+            cerr<<symbolTable.str(st->name)<<":"<<endl;
         get_constraint(st->consList, table, repeat[ID], false);
         repeat[ID]+=1;
         
@@ -2222,6 +2292,9 @@ void NonlinearVerify::add_IIS(IndexPair index){
 void NonlinearVerify::clear(){
     index_cache.clear();
     core_index.clear();
+    marks.clear();
+    encoded.clear();
+    incremental = false;
     if(table)
         delete table;
     table = NULL;
@@ -2237,12 +2310,16 @@ void NonlinearVerify::clear(){
 void NonlinearVerify::reset(){
     index_cache.clear();
     core_index.clear();
+    marks.clear();
+    encoded.clear();
+    incremental = false;
     if(table)
         delete table;
     table = NULL;
     dreal_reset(ctx);
     errs()<<"Reset dreal_context\n";
     // dreal_del_context(ctx);
+    lock_guard<mutex> guard(drealInitLock);
     dreal_init();
     ctx = dreal_mk_context(qf_nra);
     dreal_set_precision(ctx, precision);
@@ -13,6 +13,7 @@
 #include <fstream>
 #include "math.h"
 #include "DebugInfo.h"
+#include "TrailMap.h"
 
 extern int smt2set_in   (FILE *);
 extern int smt2parse    ();
@@ -21,19 +22,28 @@ extern char ** m_argv;
 
 class NonlinearVarTable{
 private:
-    dreal_context ctx;
     int var_num;
     int alloca_num;
-    map<int, double> varVal;
-    map<int, int>storeMap;
-    map<int, int> alias;
-    vector<dreal_expr> x;
-    map<int, int> exprMap;
+    int firstNum;
+    TrailMap<double> varVal;
+    TrailMap<int> storeMap;
+    TrailMap<int> alias;
+    TrailMap<dreal_expr> x;
+    dreal_context ctx;
     CFG *cfg;
+    int slot(int ID);
+    void mkX(int ID);
 public:
     NonlinearVarTable(dreal_context &c, CFG *ha);
 
     ~NonlinearVarTable();
+    void reset();
+    struct Mark{
+        unsigned varVal, storeMap, alias, x;
+        int alloca_num, var_num;
+    };
+    Mark mark();
+    void undo(const Mark &m);
 
     void setX(int ID, int time, VarType type);
     int alloca();
@@ -93,6 +103,14 @@ class NonlinearVerify: public Verify{
     void get_constraint(vector<Constraint> &consList, NonlinearVarTable *table, int time, bool isTransition);
     void encode_path(CFG* ha, vector<int> &patharray);
 
+    //incremental encoding: one solver scope per node of the path
+    bool incremental;
+    vector<int> encoded;
+    vector<NonlinearVarTable::Mark> marks;
+    unordered_map<int,int> repeat;          //times each node is on the encoded path
+    void push_node(CFG* ha, int ID, bool isTransition);
+    void pop_node();
+
     std::vector<IndexPair> index_cache; 
     std::vector<IndexPair> core_index;
 
@@ -115,6 +133,7 @@ public:
         this->outMode = output;
     }
     bool check(CFG* ha, vector<int> &path);
+    bool check_incremental(CFG* ha, vector<int> &path);
     vector<IndexPair> get_core_index(){return core_index;}
     ~NonlinearVerify();
     void print_sol(CFG* cfg);
@@ -10,92 +10,99 @@ int Nonlinear_UC_LEVEL=0;
 const int BitPerByte = 8;
 
 /***************************table of variables in linear constraints*********************************/
-    NonlinearZ3VarTable::NonlinearZ3VarTable(z3::context &ctx, CFG *ha){
-
+    NonlinearZ3VarTable::NonlinearZ3VarTable(z3::context &c, CFG *ha):varVal(0), storeMap(0), alias(0), x(z3::expr(c)), ctx(c){
         cfg = ha;
-        unsigned inputID=0;
         var_num = 0;
         alloca_num = 0;
-//        for(int i=0; i<cfg->mainInput.size();i++)
-//            errs()<<"NonlinearZ3VarTable initial "<<cfg->mainInput[i]<<"\t"<<cfg->variableList[cfg->mainInput[i]].name<<"\n";
-        for(unsigned i=0;i<cfg->variableList.size();i++)
-        {
-            Variable var =  cfg->variableList[i];
-            VarType type = var.type;
-            unsigned numBits = var.numbits;
-
-            if(inputID<cfg->mainInput.size()&&cfg->mainInput[inputID]==i){
-
-                if(type==FP){
-                	z3::expr temp = ctx.real_const(var.name.c_str());
-                    x.push_back(temp);
-                }
-                else if(type==INT){
-	             	z3::expr temp = ctx.int_const(var.name.c_str());
-                    x.push_back(temp);
-                }
-                exprMap[i] = var_num;
-                inputID++;
-                var_num++;
+        firstNum = -2;
+    }
+
+    NonlinearZ3VarTable::~NonlinearZ3VarTable(){cfg=NULL;}
+
+    /* forget the path encoded before, only the entries it touched are reverted */
+    void NonlinearZ3VarTable::reset(){
+        varVal.clear();
+        storeMap.clear();
+        alias.clear();
+        x.clear();
+        var_num = 0;
+        alloca_num = 0;
+    }
+
+    /* the symbol slot of a variable, the other types share the slot of the first FP/INT variable */
+    int NonlinearZ3VarTable::slot(int ID){
+        VarType type = cfg->variableList[ID].type;
+        if(type==FP||type==INT)
+            return ID;
+        if(firstNum==-2){
+            firstNum = -1;
+            for(unsigned i=0;i<cfg->variableList.size()&&firstNum<0;i++){
+                if(cfg->variableList[i].type==FP||cfg->variableList[i].type==INT)
+                    firstNum = i;
             }
-            else if(type==FP){
-                z3::expr temp = ctx.real_const(var.name.c_str());
-                x.push_back(temp);
-                exprMap[i] = var_num; 
-                var_num++;
+        }
+        assert(firstNum>=0 && "slot error: no FP/INT variable!");
+        return firstNum;
+    }
+
+    /* the untimed symbol of a variable, created on its first use by the path */
+    void NonlinearZ3VarTable::mkX(int ID){
+        Variable &var = cfg->variableList[ID];
+        z3::expr sym(ctx);
+        if(!symbols.lookup(ID, -1, var.type, var.numbits, sym)){
+            if(var.type==FP){
+                sym = ctx.real_const(var.name.c_str());
             }
-            else if(type==INT){
-                z3::expr temp = ctx.int_const(var.name.c_str());
-                x.push_back(temp);
-                exprMap[i] = var_num; 
-                var_num++;
+            else{
+                sym = ctx.int_const(var.name.c_str());
             }
+            symbols.insert(ID, -1, var.type, var.numbits, sym);
         }
+        x.set(ID, sym);
+        var_num++;
     }
 
-    NonlinearZ3VarTable::~NonlinearZ3VarTable(){varVal.clear();alias.clear();storeMap.clear();exprMap.clear();x.clear();cfg=NULL;}
-
     void NonlinearZ3VarTable::setX(int ID, int time, VarType type, unsigned numBits, z3::context &ctx){
 
-        int ID2 = exprMap[ID];
-        string newName = cfg->variableList[ID].name+"/t"+int2string(time);
-        if(type==FP){
-            x[ID2] = ctx.real_const(newName.c_str());           
-        }
-        else if(type==INT){
-            x[ID2] = ctx.int_const(newName.c_str());
+        int ID2 = slot(ID);
+        z3::expr sym(ctx);
+        if(!symbols.lookup(ID, time, type, numBits, sym)){
+            string newName = cfg->variableList[ID].name+"/t"+int2string(time);
+            if(type==FP){
+                sym = ctx.real_const(newName.c_str());
+            }
+            else if(type==INT){
+                sym = ctx.int_const(newName.c_str());
+            }
+            else
+                assert(false && "SetX error!!!");
+            symbols.insert(ID, time, type, numBits, sym);
         }
-        else
-            assert(false && "SetX error!!!");
+        x.set(ID2, sym);
+        var_num++;
     }
 
     int NonlinearZ3VarTable::alloca(){
-        storeMap[++alloca_num] = -2;
+        storeMap.set(++alloca_num, -2);
         return alloca_num;
     }
 
     void NonlinearZ3VarTable::setAlias(int ID1, int ID2){
-        int count = alias.count(ID2);
-        if(count)
-            ID2 = alias[ID2];
-        alias[ID1] = ID2;
+        if(alias.count(ID2))
+            ID2 = alias.get(ID2);
+        alias.set(ID1, ID2);
     }
 
     void NonlinearZ3VarTable::setAlias(Variable *v1, Variable *v2){
-        int ID1=v1->ID;
-        int ID2=v2->ID;
-        int count = alias.count(ID2);
-        if(count)
-            ID2 = alias[ID2];
-        alias[ID1] = ID2;
+        setAlias(v1->ID, v2->ID);
     }
 
     void NonlinearZ3VarTable::setVal(int ID, double val){
-        varVal[ID] = val;
+        varVal.set(ID, val);
     }
 
     void NonlinearZ3VarTable::store(int ID1, int ID2){
-        storeMap[ID1] = ID2;
+        storeMap.set(ID1, ID2);
     }
 
     int NonlinearZ3VarTable::getNum(){
@@ -103,26 +110,23 @@ const int BitPerByte = 8;
     }
     
     z3::expr NonlinearZ3VarTable::getX(int ID){
-        int count = alias.count(ID);
-        if(count)
-            ID = alias[ID];
-        int ID2 = exprMap[ID];
-        return x[ID2];
+        if(alias.count(ID))
+            ID = alias.get(ID);
+        int ID2 = slot(ID);
+        if(!x.count(ID2))
+            mkX(ID2);
+        return x.get(ID2);
     }
 
     void NonlinearZ3VarTable::setX(int ID, z3::expr expr){
-        int count = alias.count(ID);
-        if(count)
-            ID = alias[ID];
-        int ID2 = exprMap[ID];
-        x[ID2] = expr;
+        if(alias.count(ID))
+            ID = alias.get(ID);
+        x.set(slot(ID), expr);
     }
 
     int NonlinearZ3VarTable::load(int ID){
-        int count = storeMap.count(ID);
-        int storeID;
-        if(count){
-            storeID = storeMap[ID];
+        if(storeMap.count(ID)){
+            int storeID = storeMap.get(ID);
             if(storeID==-2){
                 errs()<<"GetLoad error1 "<<ID<<"\t"<<cfg->variableList[ID]<<"\n";
                 assert(false);
@@ -134,40 +138,20 @@ const int BitPerByte = 8;
             return -1;
         }
     }
+
     bool NonlinearZ3VarTable::hasAlias(Variable *v){
-        int ID = v->ID;
-        int count = alias.count(ID);
-        if(count)
-            return true;
-        else
-            return false;
+        return alias.count(v->ID);
     }
 
     Variable* NonlinearZ3VarTable::getAlias(int ID){
-        int count = alias.count(ID);
-        int aliasID;
-        if(count){
-            aliasID = alias[ID];
-        }
-        else{
-            aliasID = ID;
-        }
+        int aliasID = alias.count(ID)?alias.get(ID):ID;
         return &cfg->variableList[aliasID];
     }
 
     Variable* NonlinearZ3VarTable::getAlias(Variable* var){
         if(var->type==INTNUM||var->type==FPNUM)
             return var;
-        int ID = var->ID;
-        int count = alias.count(ID);
-        int aliasID;
-        if(count){
-            aliasID = alias[ID];
-        }
-        else{
-            aliasID = ID;
-        }
-        return &cfg->variableList[aliasID];
+        return getAlias(var->ID);
     }
 
     bool NonlinearZ3VarTable::getVal(Variable *var, double &v){
@@ -175,39 +159,33 @@ const int BitPerByte = 8;
             v=var->getVal();
             return true;
         }
-        int ID = var->ID;
-        int count = varVal.count(ID);
-        if(count){
-            v = varVal[ID];
-            return true;
-        }
-        else{
-            return false;
-        }
+        return getVal(var->ID, v);
     }
 
     bool NonlinearZ3VarTable::getVal(int ID, double &v){
-        int count = varVal.count(ID);
-        if(count){
-            v = varVal[ID];
+        if(varVal.count(ID)){
+            v = varVal.get(ID);
             return true;
         }
         else{
             return false;
         }
     }
+
     void NonlinearZ3VarTable::printAliasMap(){
         errs()<<"AliasMap:\n";
-        for(map<int,int>::iterator it=alias.begin();it!=alias.end();++it){
+        map<int, int> aliasMap = alias.toMap();
+        for(map<int,int>::iterator it=aliasMap.begin();it!=aliasMap.end();++it){
             errs()<<cfg->variableList[it->first]<<"\t\t"<<cfg->variableList[it->second]<<"\n";
         }
     }
+
     map<int, double> NonlinearZ3VarTable::getValmap(){
-           return varVal;
+           return varVal.toMap();
     }
 
     map<int, int> NonlinearZ3VarTable::getAliasmap(){
-           return alias;
+           return alias.toMap();
     }
 
     CFG *NonlinearZ3VarTable::getCFG(){
@@ -218,15 +196,21 @@ const int BitPerByte = 8;
 /*******************************solution of linear problems by z3**********************************/
 NonlinearZ3Verify::NonlinearZ3Verify(){
 	solverTime=0;
+    unknown=false;
+    table=NULL;
 }
 
 NonlinearZ3Verify::NonlinearZ3Verify(DebugInfo *d, int mode){
     solverTime=0;
+    unknown=false;
+    table=NULL;
     this->dbg = d;
     this->outMode = mode;
 }
 
 NonlinearZ3Verify::~NonlinearZ3Verify(){
+    delete table;
+    table = NULL;
     dbg = NULL;
     clear();
 }
@@ -242,6 +226,7 @@ void NonlinearZ3Verify::printVector(vector<int> &path){
 
 bool NonlinearZ3Verify::check(CFG* ha, vector<int> &path){
     clear();
+    unknown = false;
     if(outMode==1){
         printPath(ha, path);
     }
@@ -269,6 +254,8 @@ bool NonlinearZ3Verify::check(CFG* ha, vector<int> &path){
         }
     }
     catch (z3::exception ex) {
+        if(canceled)
+            return false;
         cerr << "Error: " << ex << "\n";
         throw_error("fatal error: z3 exception");
     }
@@ -1546,11 +1533,17 @@ bool NonlinearZ3Verify::get_constraint(Constraint *con, NonlinearZ3VarTable *tab
 
 /*encode the abstract into a linear costraint set */
 z3::expr_vector NonlinearZ3Verify::encode_path(CFG* ha, vector<int> &patharray){
-    NonlinearZ3VarTable *table = new NonlinearZ3VarTable(c, ha);
+    //the table is kept across checks, reset only reverts the entries of the previous path
+    if(table==NULL||table->getCFG()!=ha){
+        delete table;
+        table = new NonlinearZ3VarTable(c, ha);
+    }
+    else
+        table->reset();
 
     int state_num=(patharray.size()+1)/2;
-    int total_state  = ha->stateList.size()+ ha->transitionList.size();
-    vector<int> repeat(total_state,0);
+    //visits of every node of the path, sized by the path instead of the whole CFG
+    unordered_map<int,int> repeat;
     z3::expr_vector problem(c);
     
     for (int j= 0;j<state_num; j++){ 
@@ -1558,7 +1551,7 @@ z3::expr_vector NonlinearZ3Verify::encode_path(CFG* ha, vector<int> &patharray){
         State* st=ha->searchState(ID);
         assert(st!=NULL);
         if(outMode==1)
-            errs()<<st->name<<":\n";
+            errs()<<symbolTable.str(st->name)<<":\n";
         //encode the previous transition guard
         for(unsigned m=0;m<st->consList.size();m++){
             Constraint* con = &st->consList[m];
@@ -1584,7 +1577,6 @@ z3::expr_vector NonlinearZ3Verify::encode_path(CFG* ha, vector<int> &patharray){
     }
 
     errs()<<"Encode end\n";
-    delete table;
     return problem;
 }
 
@@ -1652,9 +1644,13 @@ bool NonlinearZ3Verify::analyze_nonlinear(z3::expr_vector problem){
     for(unsigned i=0;i<size;++i){
         s.add(problem[i]);
     }
+    if(canceled)
+        return false;
+    z3::check_result res = s.check();
     if(outMode==1){
         // cerr<<s.to_smt2()<<endl;
-        cerr<<s.check()<<endl;
+        cerr<<res<<endl;
     }
-    return (s.check()==z3::check_result::unsat);
+    unknown = (res==z3::check_result::unknown);
+    return (res==z3::check_result::unsat);
 }
@@ -10,22 +10,29 @@
 #include "MUSSAnalyzer.h"
 #include "math.h"
 #include "DebugInfo.h"
+#include "TrailMap.h"
+#include "SymbolCache.h"
 
 
 class NonlinearZ3VarTable{
 private:
     int var_num;
     int alloca_num;
-    map<int, double> varVal;
-    map<int, int>storeMap;
-    map<int, int> alias;
-    vector<z3::expr> x;
-    map<int, int> exprMap;
+    int firstNum;
+    TrailMap<double> varVal;
+    TrailMap<int> storeMap;
+    TrailMap<int> alias;
+    TrailMap<z3::expr> x;
+    SymbolCache<z3::expr> symbols;
+    z3::context &ctx;
     CFG *cfg;
+    int slot(int ID);
+    void mkX(int ID);
 
 public:
     NonlinearZ3VarTable(z3::context &ctx, CFG *ha);
     ~NonlinearZ3VarTable();
+    void reset();
     void setX(int ID, int time, VarType type, unsigned numBits, z3::context &ctx);
     int alloca();
     void setAlias(int ID1, int ID2);
@@ -52,6 +59,8 @@ class NonlinearZ3Verify: public Verify{
     int outMode;
     DebugInfo *dbg;
     double solverTime;
+    bool unknown;
+    NonlinearZ3VarTable *table;
     
     void printVector(vector<int> &path);
     z3::expr_vector encode_path(CFG* ha, vector<int> &path);
@@ -85,6 +94,8 @@ public:
     bool check(CFG* ha, vector<int> &path);
     vector<IndexPair> get_core_index(){return core_index;}
     double getTime(){return solverTime;}
+    void interrupt(){canceled=true;c.interrupt();}
+    bool isDefinitive(){return !canceled&&!unknown;}
     void print_sol(CFG* cfg);
 };
 
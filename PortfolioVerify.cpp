@@ -0,0 +1,189 @@
+#include "PortfolioVerify.h"
+#include "LinearVerify.h"
+#include "NonlinearZ3Verify.h"
+#include "NonlinearVerify.h"
+using namespace std;
+
+/*******************************class PortfolioVerify****************************************/
+PortfolioVerify::PortfolioVerify(double pre, DebugInfo *d, int mode, bool linear){
+    cfg = NULL;
+    outMode = mode;
+    dbg = d;
+    generation = 0;
+    stop = false;
+    solverTime = 0;
+    //every backend counts on its own DebugInfo, they run concurrently
+    DebugInfo *local = NULL;
+    if(linear){
+        for(unsigned seed=0;seed<2;seed++){
+            local = new DebugInfo(*d);
+            LinearVerify *v = new LinearVerify(local, mode);
+            v->setSeed(seed);
+            backends.push_back(new PortfolioBackend("LinearVerify(seed "+intToString(seed)+")", v, local, true, true));
+        }
+    }
+    else{
+        local = new DebugInfo(*d);
+        backends.push_back(new PortfolioBackend("NonlinearVerify", new NonlinearVerify(pre, local, mode), local, false, true));
+        local = new DebugInfo(*d);
+        backends.push_back(new PortfolioBackend("NonlinearZ3Verify", new NonlinearZ3Verify(local, mode), local, true, true));
+    }
+    reference = backends[0];
+    for(unsigned i=0;i<backends.size();i++){
+        PortfolioBackend *b = backends[i];
+        b->worker = thread(&PortfolioVerify::run, this, b);
+    }
+}
+
+PortfolioVerify::~PortfolioVerify(){
+    printStatistics();
+    {
+        lock_guard<mutex> guard(lock);
+        stop = true;
+        for(unsigned i=0;i<backends.size();i++){
+            if(backends[i]->busy)
+                backends[i]->verify->interrupt();
+        }
+    }
+    cond.notify_all();
+    for(unsigned i=0;i<backends.size();i++){
+        PortfolioBackend *b = backends[i];
+        b->worker.join();
+        delete b->verify;
+        delete b->dbg;
+        delete b;
+    }
+    backends.clear();
+    core_index.clear();
+    cfg = NULL;
+}
+
+/* worker loop of a backend: wait for a job, check it, publish the answer */
+void PortfolioVerify::run(PortfolioBackend *b){
+    unique_lock<mutex> guard(lock);
+    while(true){
+        cond.wait(guard, [&]{return stop||b->job!=b->done;});
+        if(stop)
+            return;
+        unsigned job = b->job;
+        vector<int> path = b->path;
+        bool incremental = b->incremental;
+        bool newTarget = b->newTarget;
+        b->newTarget = false;
+        CFG *ha = cfg;
+        guard.unlock();
+
+        if(newTarget)
+            b->verify->newTarget();
+        unsigned var0 = b->dbg->counter_var;
+        unsigned op0 = b->dbg->counter_op;
+        bool res = incremental?b->verify->check_incremental(ha, path):b->verify->check(ha, path);
+        bool definitive = b->verify->isDefinitive();
+        vector<IndexPair> core = b->verify->get_core_index();
+        double time = b->verify->getTime();
+
+        guard.lock();
+        b->varCount = b->dbg->counter_var-var0;
+        b->opCount = b->dbg->counter_op-op0;
+        b->res = res;
+        b->definitive = definitive;
+        b->core_index = core;
+        b->solverTime = time;
+        b->done = job;
+        b->busy = false;
+        cond.notify_all();
+    }
+}
+
+void PortfolioVerify::submit(PortfolioBackend *b, vector<int> &path, bool incremental, unsigned job){
+    b->path = path;
+    b->incremental = incremental;
+    b->job = job;
+    b->busy = true;
+    b->verify->resetCancel();
+}
+
+/* the backends drop what they keep for the previous target before their next job */
+void PortfolioVerify::newTarget(){
+    lock_guard<mutex> guard(lock);
+    for(unsigned i=0;i<backends.size();i++)
+        backends[i]->newTarget = true;
+}
+
+/* verify the feasibility of the path on all idle backends, return the first exact answer */
+bool PortfolioVerify::solve(CFG* ha, vector<int> &path, bool incremental){
+    unique_lock<mutex> guard(lock);
+    cfg = ha;
+    core_index.clear();
+    unsigned job = ++generation;
+
+    //the backends still busy with an earlier query sit out, at least one has to race
+    cond.wait(guard, [&]{
+        for(unsigned i=0;i<backends.size();i++)
+            if(!backends[i]->busy)
+                return true;
+        return false;
+    });
+    vector<PortfolioBackend*> racers;
+    bool referenceRaces = false;
+    for(unsigned i=0;i<backends.size();i++){
+        PortfolioBackend *b = backends[i];
+        if(b->busy)
+            continue;
+        submit(b, path, incremental, job);
+        racers.push_back(b);
+        referenceRaces = referenceRaces||b==reference;
+    }
+    cond.notify_all();
+
+    PortfolioBackend *winner = NULL;
+    cond.wait(guard, [&]{
+        bool allDone = true;
+        for(unsigned i=0;i<racers.size();i++){
+            if(racers[i]->done!=job){
+                allDone = false;
+                continue;
+            }
+            PortfolioBackend *b = racers[i];
+            if(b->definitive&&(b->res?b->satExact:b->unsatExact)){
+                winner = b;
+                return true;
+            }
+        }
+        if(allDone&&referenceRaces)
+            winner = reference;
+        return allDone;
+    });
+    for(unsigned i=0;i<racers.size();i++){
+        if(racers[i]!=winner&&racers[i]->busy)
+            racers[i]->verify->interrupt();
+    }
+    //no exact answer: the reference decides as without the portfolio, once it is free
+    if(winner==NULL){
+        cond.wait(guard, [&]{return !reference->busy;});
+        submit(reference, path, incremental, job);
+        cond.notify_all();
+        cond.wait(guard, [&]{return reference->done==job;});
+        winner = reference;
+    }
+
+    winner->wins++;
+    dbg->counter_var += winner->varCount;
+    dbg->counter_op += winner->opCount;
+    solverTime = winner->solverTime;
+    core_index = winner->core_index;
+    bool res = winner->res;
+    //backends without unsat core analysis block the whole path
+    if(!res&&core_index.empty())
+        core_index.push_back(IndexPair(0, path.size()/2));
+    if(outMode==1)
+        errs()<<"Portfolio: "<<winner->name<<" answered "<<(res?"sat":"unsat")<<"\n";
+    return res;
+}
+
+void PortfolioVerify::printStatistics(){
+    errs()<<"#Portfolio wins:";
+    for(unsigned i=0;i<backends.size();i++)
+        errs()<<"\t"<<backends[i]->name<<" "<<backends[i]->wins;
+    errs()<<"\n";
+}
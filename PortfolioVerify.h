@@ -0,0 +1,93 @@
+#ifndef _portfolioverify_h
+#define _portfolioverify_h
+#include "CFG.h"
+#include "general.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "DebugInfo.h"
+
+/* A backend of the portfolio, running its Verify on a dedicated thread */
+class PortfolioBackend{
+public:
+    string name;
+    Verify *verify;
+    DebugInfo *dbg;
+    thread worker;
+    vector<int> path;
+    bool incremental;           //the job is checked with check_incremental
+    bool newTarget;             //newTarget() is forwarded before the next job
+    //generation of the submitted job, of the finished job
+    unsigned job;
+    unsigned done;
+    bool busy;
+    bool res;
+    bool definitive;
+    vector<IndexPair> core_index;
+    double solverTime;
+    unsigned wins;
+    //whether a sat/unsat answer holds in the semantics of the CFG, see PortfolioVerify
+    bool satExact;
+    bool unsatExact;
+    //DebugInfo counts of the last job, merged into the main DebugInfo if it wins
+    unsigned varCount;
+    unsigned opCount;
+    PortfolioBackend(string name1, Verify *v, DebugInfo *d, bool sat, bool unsat){
+        name = name1;
+        verify = v;
+        dbg = d;
+        satExact = sat;
+        unsatExact = unsat;
+        varCount = 0;
+        opCount = 0;
+        incremental = false;
+        newTarget = false;
+        job = 0;
+        done = 0;
+        busy = false;
+        res = false;
+        definitive = false;
+        solverTime = 0;
+        wins = 0;
+    }
+};
+
+/* Submit every path-feasibility query to several backends at the same time and take the
+ * first definitive answer which holds in the semantics of the CFG, the losers are interrupted.
+ * A nonlinear CFG is checked over the reals: Z3 answers exactly, dReal only for unsat, its
+ * delta-sat is taken when no exact answer comes, as without the portfolio.
+ * A linear CFG is bit-precise floating point, and LinearVerify is the only backend deciding
+ * that semantics (dReal and NonlinearZ3Verify reason over the reals and would report paths
+ * infeasible in floating point as feasible). Its time on the bit-blasted FP queries depends
+ * mostly on the decisions of the SAT core, so instances with different random seeds race.
+ * A backend still busy with an earlier query (dReal can not be interrupted) sits out; the
+ * reference backend, the one used without the portfolio, is only waited for when none of
+ * the racers answers exactly. */
+class PortfolioVerify: public Verify{
+    CFG *cfg;
+    int outMode;
+    DebugInfo *dbg;
+    vector<PortfolioBackend*> backends;
+    PortfolioBackend *reference;
+    mutex lock;
+    condition_variable cond;
+    unsigned generation;
+    bool stop;
+    double solverTime;
+    std::vector<IndexPair> core_index;
+
+    void run(PortfolioBackend *b);
+    void submit(PortfolioBackend *b, vector<int> &path, bool incremental, unsigned job);
+    bool solve(CFG* ha, vector<int> &path, bool incremental);
+public:
+    PortfolioVerify(double pre, DebugInfo *d, int mode, bool linear);
+    ~PortfolioVerify();
+    bool check(CFG* ha, vector<int> &path){return solve(ha, path, false);}
+    bool check_incremental(CFG* ha, vector<int> &path){return solve(ha, path, true);}
+    void newTarget();
+    vector<IndexPair> get_core_index(){return core_index;}
+    double getTime(){return solverTime;}
+    void printStatistics();
+};
+
+#endif
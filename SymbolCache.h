@@ -0,0 +1,40 @@
+#ifndef _symbolcache_h
+#define _symbolcache_h
+#include <vector>
+using namespace std;
+
+/* Solver symbols of the variables indexed by (variable ID, time frame), kept across path checks
+ * so the SSA copies are not rebuilt from their names on every path. Time -1 is the untimed symbol.
+ * The sort (type, bits) is part of an entry, a request for another sort is a miss */
+template<class T>
+class SymbolCache{
+    vector<vector<int> > index;
+    vector<T> exprs;
+    vector<int> types;
+    vector<unsigned> bits;
+public:
+    bool lookup(int ID, int time, int type, unsigned numBits, T &expr) const{
+        if(ID>=(int)index.size()||time+1>=(int)index[ID].size())
+            return false;
+        int i = index[ID][time+1];
+        if(i<0||types[i]!=type||bits[i]!=numBits)
+            return false;
+        expr = exprs[i];
+        return true;
+    }
+    void insert(int ID, int time, int type, unsigned numBits, const T &expr){
+        if(ID>=(int)index.size())
+            index.resize(ID+1);
+        if(time+1>=(int)index[ID].size())
+            index[ID].resize(time+2, -1);
+        index[ID][time+1] = exprs.size();
+        exprs.push_back(expr);
+        types.push_back(type);
+        bits.push_back(numBits);
+    }
+    unsigned size() const{
+        return exprs.size();
+    }
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef _symboltable_h
+#define _symboltable_h
+#include <string>
+#include <deque>
+#include <unordered_map>
+using namespace std;
+
+typedef unsigned Symbol;
+
+/* Interned names of the CFG (labels, functions, states). A name is hashed once when it
+ * is interned; maps keyed by the Symbol compare integers, and the text is only read
+ * back for output. Symbol 0 is the empty name. Only the thread building the CFG interns */
+class SymbolTable{
+    unordered_map<string, Symbol> ids;
+    deque<string> text;
+public:
+    static const Symbol NONE = ~0u;
+    SymbolTable(){ intern(""); }
+    Symbol intern(const string &name){
+        unordered_map<string, Symbol>::iterator it = ids.find(name);
+        if(it!=ids.end())
+            return it->second;
+        Symbol s = text.size();
+        text.push_back(name);
+        ids.insert(make_pair(name, s));
+        return s;
+    }
+    //NONE when the name was never interned
+    Symbol lookup(const string &name) const{
+        unordered_map<string, Symbol>::const_iterator it = ids.find(name);
+        return it==ids.end()?NONE:it->second;
+    }
+    const string &str(Symbol s) const{
+        return text[s];
+    }
+    unsigned size() const{
+        return text.size();
+    }
+};
+
+extern SymbolTable symbolTable;
+
+#endif
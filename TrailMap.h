@@ -0,0 +1,121 @@
+#ifndef _trailmap_h
+#define _trailmap_h
+#include <vector>
+#include <map>
+#include <functional>
+#include <cassert>
+using namespace std;
+
+/* Dense int-keyed map of the variable tables. Every write is recorded on a trail,
+ * so undo() and clear() only revert the entries written since the mark and cost
+ * the size of the path encoded, not the number of variables of the program.
+ * A step can also be recorded: the entries it read before writing them are its inputs,
+ * the entries it wrote are its outputs, so the step can be replayed on an equal input */
+template<class T, class Eq = equal_to<T> >
+class TrailMap{
+public:
+    struct Entry{
+        int key;
+        bool had;
+        T value;
+        Entry(int k, bool h, const T &o):key(k),had(h),value(o){}
+    };
+private:
+    vector<T> val;
+    vector<char> has;
+    vector<Entry> trail;
+    T def;
+    bool recording;
+    unsigned recordMark;
+    mutable vector<pair<unsigned, Entry> > readLog;
+
+    bool present(int key) const{
+        return key>=0&&key<(int)has.size()&&has[key];
+    }
+    void logRead(int key) const{
+        if(recording)
+            readLog.push_back(make_pair((unsigned)trail.size(), Entry(key, present(key), present(key)?val[key]:def)));
+    }
+public:
+    TrailMap(const T &d):def(d){recording=false;recordMark=0;}
+    bool count(int key) const{
+        logRead(key);
+        return present(key);
+    }
+    T get(int key) const{
+        logRead(key);
+        return present(key)?val[key]:def;
+    }
+    void set(int key, const T &v){
+        assert(key>=0 && "TrailMap: negative key");
+        if(key>=(int)val.size()){
+            val.resize(key+1, def);
+            has.resize(key+1, 0);
+        }
+        trail.push_back(Entry(key, has[key]!=0, val[key]));
+        val[key] = v;
+        has[key] = 1;
+    }
+    unsigned mark() const{
+        return trail.size();
+    }
+    void undo(unsigned m){
+        while(trail.size()>m){
+            Entry &e = trail.back();
+            val[e.key] = e.value;
+            has[e.key] = e.had;
+            trail.pop_back();
+        }
+    }
+    void clear(){
+        recording = false;
+        undo(0);
+    }
+    map<int, T> toMap() const{
+        map<int, T> m;
+        for(unsigned i=0;i<trail.size();i++){
+            int key = trail[i].key;
+            if(has[key])
+                m[key] = val[key];
+        }
+        return m;
+    }
+
+    void startRecord(){
+        recording = true;
+        recordMark = trail.size();
+        readLog.clear();
+    }
+    void stopRecord(vector<Entry> &inputs, vector<Entry> &outputs){
+        recording = false;
+        map<int, unsigned> firstWrite;
+        for(unsigned i=recordMark;i<trail.size();i++){
+            if(!firstWrite.count(trail[i].key))
+                firstWrite[trail[i].key] = i;
+        }
+        for(unsigned i=0;i<readLog.size();i++){
+            typename map<int, unsigned>::iterator it = firstWrite.find(readLog[i].second.key);
+            if(it==firstWrite.end()||readLog[i].first<=it->second)
+                inputs.push_back(readLog[i].second);
+        }
+        for(typename map<int, unsigned>::iterator it=firstWrite.begin();it!=firstWrite.end();++it)
+            outputs.push_back(Entry(it->first, true, val[it->first]));
+        readLog.clear();
+    }
+    bool matches(const vector<Entry> &inputs) const{
+        for(unsigned i=0;i<inputs.size();i++){
+            const Entry &e = inputs[i];
+            if(present(e.key)!=e.had)
+                return false;
+            if(e.had&&!Eq()(val[e.key], e.value))
+                return false;
+        }
+        return true;
+    }
+    void apply(const vector<Entry> &outputs){
+        for(unsigned i=0;i<outputs.size();i++)
+            set(outputs[i].key, outputs[i].value);
+    }
+};
+
+#endif
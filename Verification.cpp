@@ -12,6 +12,15 @@ BoundedVerification::BoundedVerification(CFG* aut, int bound, vector<int> target
     this->precision=pre;
     this->dbg=dbg;
     this->outMode = outMode;
+    pairwiseAMO = false;
+    incremental = false;
+    jobs = 1;
+    portfolio = false;
+    smtWorkers = 0;
+    pipelineTime = 0;
+    iisStore = NULL;
+    firstVar = 0;
+    falseLit = Minisat::lit_Undef;
     solver_time = 0;
     result = false;
     reachEnd = false;
@@ -27,6 +36,25 @@ BoundedVerification::BoundedVerification(CFG* aut, int bound, vector<int> target
     }
 }
 
+/* race the backends on every path instead of using the single one chosen by cfg->isLinear() */
+void BoundedVerification::setPortfolio(bool portfolio){
+    if(this->portfolio==portfolio)
+        return;
+    this->portfolio = portfolio;
+    delete verify;
+    verify = new_verify(dbg);
+}
+
+/* create the path-feasibility backend configured for this verification */
+Verify* BoundedVerification::new_verify(DebugInfo *d){
+    if(portfolio)
+        return new PortfolioVerify(precision, d, outMode, cfg->isLinear());
+    else if(cfg->isLinear())
+        return new LinearVerify(d, outMode);
+    else
+        return new NonlinearVerify(precision, d, outMode);
+}
+
 BoundedVerification::~BoundedVerification(){
     delete verify;
     verify = NULL;
@@ -61,18 +89,15 @@ void BoundedVerification::DFS(int intbound,int bound,int start, int end){
             path.pop_back();
         path.push_back(temp);
     }
-    if(path.empty()||verify->check(cfg, path))
-        path.push_back(start);
-    else
-        return;
+    path.push_back(start);
     
     if(start==end){
         reachEnd = true;
         target_name=cfg->getNodeName(end);
     }
 
-
-    if(verify->check(cfg, path)){   //the path is feasible, terminate
+    //one check per transition and state, the backend keeps the encoding of the common prefix
+    if(verify->check_incremental(cfg, path)){   //the path is feasible, terminate
         num_of_path++;
         if(reachEnd){
             reachPath=get_name(cfg,path);
@@ -83,11 +108,11 @@ void BoundedVerification::DFS(int intbound,int bound,int start, int end){
             return;
         }
         else {
-            for(int i=cfg->searchState(start)->transList.size()-1;i>=0;--i){
-                State *s = cfg->searchState(start)->transList[i]->toState;
-                if(s==NULL) continue;
-                path.push_back(cfg->searchState(start)->transList[i]->ID);
-                DFS(intbound,bound-1,s->ID,end);
+            for(int i=cfg->outDegree(start)-1;i>=0;--i){
+                int next = cfg->succTarget(start, i);
+                if(next<0) continue;
+                path.push_back(cfg->succTransition(start, i));
+                DFS(intbound,bound-1,next,end);
             }
         }
     }
@@ -99,8 +124,6 @@ void BoundedVerification::DFS(int intbound,int bound,int start, int end){
 bool BoundedVerification::check(string check){
 //    cfg->print();
 
-    int line;
-
     encode_graph();    
 
     if(outMode!=0)
@@ -112,76 +135,235 @@ bool BoundedVerification::check(string check){
     
     if(outMode!=0){
         for(int i=0;i<(int)target.size();i++)
-            errs()<<"target["<<i<<"]:"<<cfg->stateList[target[i]].name<<"("<<cfg->stateList[target[i]].error<<")\n";
+            errs()<<"target["<<i<<"]:"<<symbolTable.str(cfg->stateList[target[i]]->name)<<"("<<cfg->stateList[target[i]]->error<<")\n";
     }
     errs()<<"\n";
+    if(jobs>1 && target.size()>1)
+        return check_parallel(check);
+    if(incremental && cfg->isLinear()){
+        vector<bool> reached;
+        vector<int> pathNum;
+        vector<double> targetTime;
+        solve_all(reached, pathNum, targetTime);
+        for(int i=0;i<(int)target.size();i++){
+            result = reached[i];
+            witPath.clear();
+            solver_time += targetTime[i];
+            report(errs(), i, target[i], check, pathNum[i], targetTime[i]);
+        }
+        return result;
+    }
     for(int i=0;i<(int)target.size();i++){
-        result = false;
-        reachEnd = false;
-        path.clear();
-        witPath.clear();
         if(outMode==1)
-            errs()<<"target["<<i<<"]:"<<cfg->stateList[target[i]].name<<"("<<target[i]<<")\n";
+            errs()<<"target["<<i<<"]:"<<symbolTable.str(cfg->stateList[target[i]]->name)<<"("<<target[i]<<")\n";
         int targetID = target[i];
-        
-    	if(cfg->isLinear())	
-    		result=solve(targetID);
-    	else        
-    		DFS(bound,bound,cfg->initialState->ID,targetID);
-
-        string name = cfg->stateList[targetID].name;
-        if(name.at(0)=='q')
-            line = cfg->stateList[targetID].locList[0];
-        if(outMode==1)
-            errs()<<"target["<<i<<"]:from "<<cfg->initialState->name<<"("<<cfg->initialState->ID<<") to "<<cfg->stateList[targetID].name<<"("<<targetID<<")\n";
-        errs()<<cfg->stateList[targetID].error;
-        if(cfg->stateList[targetID].error==Spec)
-            errs()<<"with expr \""<<check<<"\" ";
-        int originLine=line;
-        if(check!="")
-            originLine=line-1;
-        if( result ){
-            errs()<<"at line "<<originLine<<" in state "<<target_name<<" is reachable, When\n";
-            // verify->print_sol(cfg);
-            errs()<<"Number of path checked:"<<num_of_path<<"\n";
-
-            if(outMode==1){
-                errs()<<"Witness:\n";
-                for(unsigned i=0; i<witPath.size();i++){
-                    int id = witPath[i];
-                    State *s = cfg->searchState(id);
-                    assert(s!=NULL);
-                    cerr<<"\t"<<s->name<<":";
-                    cerr<<"\tLocLine:";
-                    for(unsigned j=0;j<s->locList.size();j++)
-                        cerr<<s->locList[j]<<";";
-                    cerr<<"\n";
-                    if(i<witPath.size()-1){
-                        Transition *t = cfg->searchTransition(witPath[++i]);
-                        assert(t!=NULL);
-                        cerr<<"\t"<<t->name<<"\n";
-                    }
+        check_target(targetID);
+
+        double time = last_time();
+        solver_time += time;
+        report(errs(), i, targetID, check, num_of_path, time);
+    }
+
+    return result;
+}
+
+/* check the reachability of a single target state */
+bool BoundedVerification::check_target(int targetID){
+    result = false;
+    reachEnd = false;
+    path.clear();
+    witPath.clear();
+    verify->newTarget();
+    if(cfg->isLinear())	
+        result=solve(targetID);
+    else        
+        DFS(bound,bound,cfg->initialState->ID,targetID);
+    return result;
+}
+
+/* Parallel check with jobs workers. Every worker owns a BoundedVerification, i.e. its own SAT
+ * instance and Z3/dReal backend, and shares only the CFG which is read-only during verification.
+ * Workers pull targets from a shared counter (or own a group of targets in the incremental mode),
+ * the results are printed in completion order */
+bool BoundedVerification::check_parallel(string check){
+    int workerNum = jobs<(int)target.size()?jobs:target.size();
+    atomic<int> next(0);
+    mutex outLock;
+    vector<thread> workers;
+    errs()<<"#Workers:\t"<<workerNum<<"\n";
+    //the targets finish in any order, the program is unsafe if any of them is reachable
+    result = false;
+
+    for(int w=0;w<workerNum;w++){
+        workers.push_back(thread([&, w](){
+            DebugInfo localDbg(*dbg);
+            vector<int> group;
+            for(unsigned i=w;i<target.size()&&incremental;i+=workerNum)
+                group.push_back(i);
+            vector<int> groupTarget;
+            for(unsigned i=0;i<group.size();i++)
+                groupTarget.push_back(target[group[i]]);
+
+            BoundedVerification worker(cfg, bound, incremental?groupTarget:target, precision, &localDbg, outMode);
+            worker.setPairwiseAMO(pairwiseAMO);
+            worker.setPortfolio(portfolio);
+            worker.setPipeline(smtWorkers);
+            worker.setIISStore(iisStore);
+            worker.encode_graph();
+
+            if(incremental && cfg->isLinear()){
+                vector<bool> reached;
+                vector<int> pathNum;
+                vector<double> targetTime;
+                worker.solve_all(reached, pathNum, targetTime);
+                string out;
+                raw_string_ostream os(out);
+                double time = 0;
+                bool any = false;
+                for(unsigned i=0;i<group.size();i++){
+                    worker.result = reached[i];
+                    any = any||reached[i];
+                    worker.report(os, group[i], target[group[i]], check, pathNum[i], targetTime[i]);
+                    time += targetTime[i];
+                }
+                os.flush();
+                lock_guard<mutex> guard(outLock);
+                errs()<<out;
+                solver_time += time;
+                num_of_path += worker.num_of_path;
+                if(any)
+                    result = true;
+                return;
+            }
+            int i;
+            while((i=next++)<(int)target.size()){
+                //the worker counts the paths of all its targets, report those of target i only
+                int before = worker.num_of_path;
+                bool res = worker.check_target(target[i]);
+                double time = worker.last_time();
+                string out;
+                raw_string_ostream os(out);
+                worker.report(os, i, target[i], check, worker.num_of_path-before, time);
+                os.flush();
+                lock_guard<mutex> guard(outLock);
+                errs()<<out;
+                solver_time += time;
+                if(res)
+                    result = true;
+            }
+            lock_guard<mutex> guard(outLock);
+            num_of_path += worker.num_of_path;
+        }));
+    }
+    for(unsigned w=0;w<workers.size();w++)
+        workers[w].join();
+    return result;
+}
+
+/* print the verification result of target[i] */
+void BoundedVerification::report(raw_ostream &os, int i, int targetID, string check, int pathNum, double time){
+    int line = 0;
+    const string &name = symbolTable.str(cfg->stateList[targetID]->name);
+    if(name.at(0)=='q')
+        line = cfg->stateList[targetID]->locList[0];
+    if(outMode==1)
+        os<<"target["<<i<<"]:from "<<symbolTable.str(cfg->initialState->name)<<"("<<cfg->initialState->ID<<") to "<<name<<"("<<targetID<<")\n";
+    os<<cfg->stateList[targetID]->error;
+    if(cfg->stateList[targetID]->error==Spec)
+        os<<"with expr \""<<check<<"\" ";
+    int originLine=line;
+    if(check!="")
+        originLine=line-1;
+    if( result ){
+        os<<"at line "<<originLine<<" in state "<<target_name<<" is reachable, When\n";
+        // verify->print_sol(cfg);
+        os<<"Number of path checked:"<<pathNum<<"\n";
+
+        if(outMode==1){
+            os<<"Witness:\n";
+            for(unsigned i=0; i<witPath.size();i++){
+                int id = witPath[i];
+                State *s = cfg->searchState(id);
+                assert(s!=NULL);
+                os<<"\t"<<symbolTable.str(s->name)<<":";
+                os<<"\tLocLine:";
+                for(unsigned j=0;j<s->locList.size();j++)
+                    os<<s->locList[j]<<";";
+                os<<"\n";
+                if(i<witPath.size()-1){
+                    Transition *t = cfg->searchTransition(witPath[++i]);
+                    assert(t!=NULL);
+                    os<<"\t"<<t->name<<"\n";
                 }
             }
         }
-        else{
-            errs()<<"at line "<<originLine<<" is unreachable under bound "<<bound<<"\n";
-            errs()<<"Number of path checked:"<<num_of_path<<"\n";
-        }
-        if(outMode!=0)
-        {
-            errs()<<"#Avg_var: "<<dbg->counter_var*1.0/num_of_path<<"\n";
-            errs()<<"#Avg_nolinearop: "<<dbg->counter_op*1.0/num_of_path<<"\n";
-        }
-        double time = verify->getTime();
-        solver_time += time;
-        errs() << "Solver Time: \t" << ConvertToString(time) << "ms\n\n";
     }
+    else{
+        os<<"at line "<<originLine<<" is unreachable under bound "<<bound<<"\n";
+        os<<"Number of path checked:"<<pathNum<<"\n";
+    }
+    if(outMode!=0&&pathNum>0)
+    {
+        os<<"#Avg_var: "<<dbg->counter_var*1.0/pathNum<<"\n";
+        os<<"#Avg_nolinearop: "<<dbg->counter_op*1.0/pathNum<<"\n";
+    }
+    os << "Solver Time: \t" << ConvertToString(time) << "ms\n\n";
+}
 
-    return result;
+/* Incremental deepening over all targets at once: at step i one SAT query asks for
+ * any undecided target, guarded by an activation literal which is retired afterwards.
+ * Depths are explored in increasing order, so the first witness of a target is a shortest one,
+ * and the learned clauses and IIS clauses are kept across depths and targets */
+void BoundedVerification::solve_all(vector<bool> &reached, vector<int> &pathNum, vector<double> &targetTime){
+    reached.assign(target.size(), false);
+    pathNum.assign(target.size(), 0);
+    targetTime.assign(target.size(), 0);
+    unsigned undecided = target.size();
+
+    for(int i=0;i<=bound&&undecided>0;i++){
+        bool found = true;
+        while(found&&undecided>0){
+            found = false;
+            Minisat::vec<Minisat::Lit> lits;
+            Minisat::Lit act = Minisat::mkLit(s.newVar());
+            for(unsigned t=0;t<target.size();t++){
+                if(!reached[t])
+                    lits.push(var(i,target[t]));
+            }
+            lits.push(~act);
+            s.addClause(lits);
+
+            while(s.solve(act)){
+                num_of_path++;
+                unsigned t=0;
+                while(t<target.size()&&(reached[t]||s.modelValue(var(i,target[t]))!=Minisat::l_True))
+                    t++;
+                assert(t<target.size());
+                pathNum[t]++;
+                vector<int> path=decode_path(target[t]);
+                bool feasible = verify->check(cfg, path);
+                targetTime[t] += verify->getTime();
+                if(feasible){   //the path is feasible, target t is decided
+                    reachPath=get_path_name(cfg,path);
+                    if(outMode==1)
+                        errs()<<"target["<<t<<"] reached at step "<<i<<": "<<reachPath<<"\n";
+                    reached[t] = true;
+                    undecided--;
+                    found = true;
+                    break;
+                }
+                else                //infeasible, feed the IIS path to the SAT solver
+                    block_path(num_of_path,cfg,path);
+            }
+            //retire the activation literal
+            s.addClause(~act);
+        }
+    }
 }
 
 bool BoundedVerification::solve(int cur_target){
+    if(smtWorkers>0)
+        return solve_pipeline(cur_target);
 
     for(int i=0;i<=bound;i++){
         while(true){
@@ -205,10 +387,99 @@ bool BoundedVerification::solve(int cur_target){
 }
 
 
+/* Pipelined solve: the SAT side keeps enumerating candidate paths, blocking each one
+ * speculatively, and feeds them through a bounded queue to smtWorkers SMT workers with their
+ * own backends. The IIS segments of infeasible paths come back to the SAT side as clauses. */
+bool BoundedVerification::solve_pipeline(int cur_target){
+    unsigned capacity = 2*smtWorkers;
+    WorkQueue<PathJob> queue(capacity);
+    WorkQueue<PathJob> answers;
+    vector<thread> workers;
+    for(int w=0;w<smtWorkers;w++){
+        workers.push_back(thread([&](){
+            DebugInfo localDbg(*dbg);
+            Verify *smt = new_verify(&localDbg);
+            PathJob job;
+            while(queue.pop(job)){
+                job.feasible = smt->check(cfg, job.path);
+                job.core_index = smt->get_core_index();
+                job.time = smt->getTime();
+                answers.push(job);
+            }
+            delete smt;
+        }));
+    }
+
+    bool found = false;
+    unsigned inflight = 0;
+    double time = 0;
+    PathJob answer;
+    for(int i=0;i<=bound&&!found;i++){
+        while(!found){
+            //collect the finished answers, blocking while the queue is full
+            bool wait = (inflight>=capacity);
+            while(inflight>0&&(wait?answers.pop(answer):answers.try_pop(answer))){
+                wait = false;
+                inflight--;
+                time += answer.time;
+                if(answer.feasible){   //the path is feasible, terminate
+                    reachPath=get_path_name(cfg,answer.path);
+                    found = true;
+                    break;
+                }
+                block_path(answer.path, answer.core_index);
+            }
+            if(found)
+                break;
+            if(inflight>=capacity)
+                continue;
+
+            if(s.solve(var(i,cur_target))){
+                num_of_path++;
+                vector<int> path=decode_path(cur_target);
+                //block the candidate speculatively, its IIS segments follow once checked
+                Minisat::vec<Minisat::Lit> lits;
+                for(unsigned j=0;j<path.size();j++)
+                    lits.push(~var(j/2,path[j]));
+                s.addClause(lits);
+                queue.push(PathJob(num_of_path, path));
+                inflight++;
+            }
+            else if(inflight>0){
+                //step i is exhausted only if the pending candidates are infeasible
+                answers.pop(answer);
+                inflight--;
+                time += answer.time;
+                if(answer.feasible){
+                    reachPath=get_path_name(cfg,answer.path);
+                    found = true;
+                }
+                else
+                    block_path(answer.path, answer.core_index);
+            }
+            else
+                break;
+        }
+    }
+    //drop the candidates nobody has picked up yet
+    PathJob pending;
+    while(queue.try_pop(pending));
+    queue.close();
+    for(unsigned w=0;w<workers.size();w++)
+        workers[w].join();
+    while(answers.try_pop(answer))
+        time += answer.time;
+    pipelineTime = time;
+    return found;
+}
+
 /* extract the infeasible path segement and feed to the SAT solver */
 void  BoundedVerification::block_path(int number,CFG *cfg,vector<int> path){
+    block_path(path, verify->get_core_index());
+}
+
+void  BoundedVerification::block_path(vector<int> &path, vector<IndexPair> indexs){
     
-    vector<IndexPair> indexs = verify->get_core_index();
 //printVector(path);
 //printIndex(indexs);
     for(unsigned m=0;m<indexs.size();m++){
@@ -222,60 +493,146 @@ void  BoundedVerification::block_path(int number,CFG *cfg,vector<int> path){
         pathsegment.push_back(path[2*pathEnd]);
         
 //errs()<<"IIS Path "<<number<<":"<<get_path_name(cfg,pathsegment)<<"\n\n";    
-        int loop = bound-(pathEnd-pathStart);
-        for(int i=0;i<=loop;i++){
-            Minisat::vec<Minisat::Lit> lits;
-            for(unsigned j=0;j<pathsegment.size();j++){
-                lits.push(~var(i+j/2,pathsegment[j]));    
-            //    errs()<<"v("<<i+j/2<<","<<pathsegment[j]<<")"<<"\n";
+        block_segment(pathsegment);
+        if(iisStore)
+            iisStore->add(pathsegment);
+    }
+}
+
+/* block the segment state,transition,...,state at every step it fits in the bound */
+void  BoundedVerification::block_segment(vector<int> &pathsegment){
+    int loop = bound-(int)(pathsegment.size()/2);
+    for(int i=0;i<=loop;i++){
+        Minisat::vec<Minisat::Lit> lits;
+        for(unsigned j=0;j<pathsegment.size();j++){
+            lits.push(~var(i+j/2,pathsegment[j]));    
+        //    errs()<<"v("<<i+j/2<<","<<pathsegment[j]<<")"<<"\n";
+        }
+        s.addClause(lits);            
+    }
+}
+
+/* the nodes a path from the initial state can be at on each step: the states of step k+1 are
+ * the targets of the transitions leaving the states of step k and the states without successor */
+void BoundedVerification::reach_steps(){
+    unsigned state_num=cfg->stateList.size()+cfg->transitionList.size();
+    vector<int> seen(state_num, -1);
+    vector<int> states, next;
+    for(unsigned i=0;i<cfg->stateList.size();i++){
+        if(cfg->stateList[i]->isInitial)
+            states.push_back(cfg->stateList[i]->ID);
+    }
+    reachNode.clear();
+    stepStart.clear();
+    for(int k=0;k<=bound;k++){
+        stepStart.push_back(reachNode.size());
+        next.clear();
+        for(unsigned i=0;i<states.size();i++){
+            int st = states[i];
+            reachNode.push_back(st);
+            if(k==bound)
+                continue;
+            if(cfg->outDegree(st)==0&&seen[st]!=k+1){
+                seen[st] = k+1;
+                next.push_back(st);
+            }
+            for(int j=0;j<cfg->outDegree(st);j++){
+                int to = cfg->succTarget(st, j);
+                if(to<0) continue;
+                reachNode.push_back(cfg->succTransition(st, j));
+                if(seen[to]!=k+1){
+                    seen[to] = k+1;
+                    next.push_back(to);
+                }
             }
-            s.addClause(lits);            
         }
+        sort(reachNode.begin()+stepStart.back(), reachNode.end());
+        states.swap(next);
+        sort(states.begin(), states.end());
     }
+    stepStart.push_back(reachNode.size());
 }
 
-/*encode the bounded graph structure of LHA into a propositional formula set*/
+/*encode the bounded graph structure of LHA into a propositional formula set.
+ * Only the nodes reachable at a step get a variable, the others are the constant falseLit */
 void BoundedVerification::encode_graph(){
     Minisat::vec<Minisat::Lit> lits;
-    //initial condition    
-    for(unsigned i=0;i<cfg->stateList.size();i++){
-        State* st = &cfg->stateList[i];
-        if(st->isInitial)
-            s.addClause(var(0,st->ID));
-        else
-            s.addClause(~var(0,st->ID));
-    }
+    reach_steps();
+    falseLit = Minisat::mkLit(s.newVar());
+    s.addClause(~falseLit);
+    firstVar = s.nVars();
+    for(unsigned i=0;i<reachNode.size();i++)
+        s.newVar();
+
+    //initial condition, the states of step 0 are the initial ones
+    for(int i=stepStart[0];i<stepStart[1];i++)
+        s.addClause(var(0,reachNode[i]));
 
-    //not exactly in one location and transition, exclude condition
+    //the states and the transitions reachable at step k
+    vector<vector<int> > stepStates(bound+1), stepTrans(bound+1);
     for(int k=0;k<=bound;k++){
-        for(unsigned i=0;i<cfg->stateList.size();i++){
-            for(unsigned j=i+1;j<cfg->stateList.size();j++){
-                s.addClause(~var(k,cfg->stateList[i].ID), ~var(k,cfg->stateList[j].ID));
-            }
+        for(int i=stepStart[k];i<stepStart[k+1];i++){
+            if(cfg->is_state(reachNode[i]))
+                stepStates[k].push_back(reachNode[i]);
+            else
+                stepTrans[k].push_back(reachNode[i]);
         }
-        for(unsigned i=0;i<cfg->transitionList.size();i++){
-            for(unsigned j=i+1;j<cfg->transitionList.size();j++){
-                s.addClause(~var(k,cfg->transitionList[i].ID), ~var(k,cfg->transitionList[j].ID));
+    }
+
+    if(pairwiseAMO){
+        //not exactly in one location and transition, exclude condition
+        for(int k=0;k<=bound;k++){
+            for(unsigned i=0;i<stepStates[k].size();i++){
+                for(unsigned j=i+1;j<stepStates[k].size();j++){
+                    s.addClause(~var(k,stepStates[k][i]), ~var(k,stepStates[k][j]));
+                }
             }
+            for(unsigned i=0;i<stepTrans[k].size();i++){
+                for(unsigned j=i+1;j<stepTrans[k].size();j++){
+                    s.addClause(~var(k,stepTrans[k][i]), ~var(k,stepTrans[k][j]));
+                }
+            }
+        }
+    }
+
+    //some transition is taken at step k, only used by the sequential encoding
+    vector<Minisat::Lit> anyTran;
+    if(!pairwiseAMO){
+        for(int k=0;k<=bound;k++){
+            lits.clear();
+            for(unsigned i=0;i<stepStates[k].size();i++)
+                lits.push(var(k,stepStates[k][i]));
+            at_most_one(lits);
+            lits.clear();
+            for(unsigned i=0;i<stepTrans[k].size();i++)
+                lits.push(var(k,stepTrans[k][i]));
+            anyTran.push_back(at_most_one(lits));
         }
     }
+
     // transition relation 
-    for(unsigned i=0;i<cfg->stateList.size();i++){
-        State* st = &cfg->stateList[i];            
-        for(int k=0;k<bound;k++){
-            Minisat::Lit x=var(k,st->ID);
-            if(st->transList.size()==0){
-                s.addClause(~x,var(k+1,st->ID));
-                for(unsigned j=0;j<cfg->transitionList.size();j++){
-                    s.addClause(~x, ~var(k,cfg->transitionList[j].ID));
+    for(int k=0;k<bound;k++){
+        for(unsigned i=0;i<stepStates[k].size();i++){
+            int st = stepStates[k][i];
+            Minisat::Lit x=var(k,st);
+            if(cfg->outDegree(st)==0){
+                s.addClause(~x,var(k+1,st));
+                if(!pairwiseAMO){
+                    if(anyTran[k]!=Minisat::lit_Undef)
+                        s.addClause(~x, ~anyTran[k]);
+                }
+                else{
+                    for(unsigned j=0;j<stepTrans[k].size();j++){
+                        s.addClause(~x, ~var(k,stepTrans[k][j]));
+                    }
                 }
             }
             else{    
                 lits.clear();
-                for(unsigned j=0;j<st->transList.size();j++){
-                    if(st->transList[j]->toState==NULL) continue;
-                    Minisat::Lit next_tran_exp=var(k,st->transList[j]->ID);
-                    Minisat::Lit next_state_exp=var(k+1,st->transList[j]->toState->ID);
+                for(int j=0;j<cfg->outDegree(st);j++){
+                    if(cfg->succTarget(st, j)<0) continue;
+                    Minisat::Lit next_tran_exp=var(k,cfg->succTransition(st, j));
+                    Minisat::Lit next_state_exp=var(k+1,cfg->succTarget(st, j));
                     s.addClause(~x, ~next_tran_exp, next_state_exp);
                     lits.push(next_tran_exp);
                 }
@@ -284,6 +641,33 @@ void BoundedVerification::encode_graph(){
             }
         }
     }
+    //infeasible segments found by previous runs
+    if(iisStore){
+        vector<vector<int> > segments = iisStore->getSegments();
+        for(unsigned i=0;i<segments.size();i++)
+            block_segment(segments[i]);
+        if(outMode!=0)
+            errs()<<"#IIS preloaded:\t"<<segments.size()<<"\n";
+    }
+    if(outMode!=0)
+        errs()<<"#SAT encoding("<<(pairwiseAMO?"pairwise":"sequential")<<"):\tvars "<<s.nVars()<<"\tclauses "<<s.nClauses()<<"\n";
+}
+
+/* sequential counter at-most-one constraint over lits, 
+ * returns a register literal implied by every literal of lits (lit_Undef if lits is empty) */
+Minisat::Lit BoundedVerification::at_most_one(Minisat::vec<Minisat::Lit> &lits){
+    if(lits.size()==0)
+        return Minisat::lit_Undef;
+    Minisat::Lit pre = Minisat::mkLit(s.newVar());
+    s.addClause(~lits[0], pre);
+    for(int i=1;i<lits.size();i++){
+        Minisat::Lit reg = Minisat::mkLit(s.newVar());
+        s.addClause(~lits[i], reg);
+        s.addClause(~pre, reg);
+        s.addClause(~lits[i], ~pre);
+        pre = reg;
+    }
+    return pre;
 }
 
 /*
@@ -299,12 +683,11 @@ Minisat::vec<Minisat::Lit> BoundedVerification::setTarget(int cur_target){
 /* decode a path from a satisfiable model */
 vector<int>  BoundedVerification::decode_path(int cur_target){
     assert(s.okay());
-    int state_num=cfg->stateList.size()+cfg->transitionList.size();;
     int* path=new int[2*bound+1];
-    for (int i=1;i<=state_num*(bound+1); i++) {
-        if(s.modelValue(i) == Minisat::l_True){
+    for (unsigned i=0;i<reachNode.size(); i++) {
+        if(s.modelValue(firstVar+i) == Minisat::l_True){
             int id,loop;
-            decode(i,loop,id);
+            decode(firstVar+i,loop,id);
             if(cfg->is_state(id))
                 path[2*loop]=id;
             else
@@ -344,17 +727,21 @@ string BoundedVerification::get_path_name(CFG *cfg,vector<int> path){
     }
     return name;
 }
+/* the variable of node st at step loop, falseLit if no path is at st then */
 Minisat::Lit BoundedVerification::var(const int loop, const int st){
-    int state_num=cfg->stateList.size()+cfg->transitionList.size();;
-    int var= state_num*loop+st+1;
-    while (var >= s.nVars()-1) s.newVar();
-    return Minisat::mkLit(var);
+    if(loop<0||loop>bound)
+        return falseLit;
+    vector<int>::iterator first = reachNode.begin()+stepStart[loop];
+    vector<int>::iterator last = reachNode.begin()+stepStart[loop+1];
+    vector<int>::iterator it = lower_bound(first, last, st);
+    if(it==last||*it!=st)
+        return falseLit;
+    return Minisat::mkLit(firstVar+(it-reachNode.begin()));
 }
 
 void BoundedVerification::decode(int code,int& loop,int& ID){
-    code--;
-    int state_num=cfg->stateList.size()+cfg->transitionList.size();;
-    loop = code/state_num;
-    ID = code%state_num;
+    int i = code-firstVar;
+    loop = upper_bound(stepStart.begin(), stepStart.end(), i)-stepStart.begin()-1;
+    ID = reachNode[i];
 }
 
@@ -12,15 +12,39 @@
 //#include "dreal_c.h"
 #include <fstream>
 #include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
 #include "LinearVerify.h"
 #include "NonlinearZ3Verify.h"
 #include "NonlinearVerify.h"
+#include "PortfolioVerify.h"
+#include "WorkQueue.h"
+#include "IISStore.h"
+
+/* a candidate path sent to the SMT workers of the pipeline, and its answer */
+class PathJob{
+public:
+    int number;
+    vector<int> path;
+    bool feasible;
+    vector<IndexPair> core_index;
+    double time;
+    PathJob(){number=0;feasible=false;time=0;}
+    PathJob(int n, vector<int> p){number=n;path=p;feasible=false;time=0;}
+};
 
 class BoundedVerification{
 public:
     BoundedVerification(CFG* aut,int bound,vector<int> target,double pre, DebugInfo *dbg, int outMode);
     bool check(string check);
     double getSolverTime(){return solver_time;}
+    void setPairwiseAMO(bool pairwise){this->pairwiseAMO = pairwise;}
+    void setIncremental(bool incremental){this->incremental = incremental;}
+    void setJobs(int jobs){this->jobs = jobs;}
+    void setPortfolio(bool portfolio);
+    void setPipeline(int smtWorkers){this->smtWorkers = smtWorkers;}
+    void setIISStore(IISStore *store){this->iisStore = store;}
     ~BoundedVerification();
 private:
     Verify *verify;
@@ -31,6 +55,13 @@ private:
     bool reachEnd;
     int bound;
     int outMode;
+    bool pairwiseAMO;
+    bool incremental;
+    int jobs;
+    bool portfolio;
+    int smtWorkers;
+    double pipelineTime;
+    IISStore *iisStore;
     string reachPath;
     string target_name;
     double solver_time;
@@ -42,11 +73,28 @@ private:
     void DFS(int intbound,int bound,int start,int end);
     Minisat::Solver s;
     bool solve(int cur_target);
+    bool solve_pipeline(int cur_target);
+    Verify* new_verify(DebugInfo *d);
+    double last_time(){return smtWorkers>0&&cfg->isLinear()?pipelineTime:verify->getTime();}
+    bool check_target(int targetID);
+    bool check_parallel(string check);
+    void solve_all(vector<bool> &reached, vector<int> &pathNum, vector<double> &targetTime);
+    void report(raw_ostream &os, int i, int targetID, string check, int pathNum, double time);
+    //a variable exists only for a node reachable at a step: variable firstVar+i is node reachNode[i],
+    //the nodes of step k are reachNode[stepStart[k]..stepStart[k+1]), sorted
+    vector<int> reachNode;
+    vector<int> stepStart;
+    int firstVar;
+    Minisat::Lit falseLit;
+    void reach_steps();
     void encode_graph();
+    Minisat::Lit at_most_one(Minisat::vec<Minisat::Lit> &lits);
 //    Minisat::vec<Minisat::Lit> setTarget(int cur_target);
     Minisat::Lit var(const int loop, const int ID);
     void decode(int code, int& loop, int& ID);
     void block_path(int number,CFG *cfg,vector<int> path);
+    void block_path(vector<int> &path, vector<IndexPair> indexs);
+    void block_segment(vector<int> &pathsegment);
     vector<int> decode_path(int cur_target);
 };
 
@@ -0,0 +1,65 @@
+#ifndef WORKQUEUE_H
+#define WORKQUEUE_H
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+/* A blocking FIFO shared by producer and consumer threads.
+ * push blocks while the queue holds capacity items (capacity 0: unbounded),
+ * pop blocks while the queue is empty, and fails once it is closed and drained. */
+template <class T>
+class WorkQueue{
+    std::deque<T> items;
+    std::mutex lock;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    unsigned capacity;
+    bool closed;
+public:
+    WorkQueue(unsigned cap=0):capacity(cap),closed(false){}
+
+    bool push(const T &item){
+        std::unique_lock<std::mutex> guard(lock);
+        notFull.wait(guard, [&]{return closed||capacity==0||items.size()<capacity;});
+        if(closed)
+            return false;
+        items.push_back(item);
+        notEmpty.notify_one();
+        return true;
+    }
+
+    bool pop(T &item){
+        std::unique_lock<std::mutex> guard(lock);
+        notEmpty.wait(guard, [&]{return closed||!items.empty();});
+        if(items.empty())
+            return false;
+        item = items.front();
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    bool try_pop(T &item){
+        std::lock_guard<std::mutex> guard(lock);
+        if(items.empty())
+            return false;
+        item = items.front();
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close(){
+        std::lock_guard<std::mutex> guard(lock);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    unsigned size(){
+        std::lock_guard<std::mutex> guard(lock);
+        return items.size();
+    }
+};
+
+#endif
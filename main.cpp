@@ -8,7 +8,7 @@ using namespace std;
 string split(string filename);
 void printUsage();
 void compile(string name, int o);
-void opt(string name, int b, double p, int m, char* f, char* e, int o);
+void opt(string name, int b, double p, int m, char* f, char* e, int o, string extra);
 void addExpr(string name, string expr);
 string inttostring(const int i);
 string doubletostring(const double d);
@@ -32,6 +32,7 @@ int main(int argc, char* argv[]){
     bool mode_a=false;
     bool mode_d=false;
     int output=0;
+    string extra="";
     for(int i = 2; i < argc; i ++){
         if(argv[i][0] == '-' && strlen(argv[i]) == 2){
             if(argv[i][1] == 'f'){
@@ -66,6 +67,49 @@ int main(int argc, char* argv[]){
             else if(argv[i][1] == 't'){
                 output=2;
             }
+            else if(argv[i][1] == 'w'){
+                extra+=" -pairwise";
+            }
+            else if(argv[i][1] == 'i'){
+                extra+=" -incremental";
+            }
+            else if(argv[i][1] == 'r'){
+                extra+=" -portfolio";
+            }
+            else if(argv[i][1] == 'n'){
+                extra+=" -pipeline="+string(argv[i+1]);
+                i ++;
+            }
+            else if(argv[i][1] == 'm'){
+                extra+=" -mus-budget="+string(argv[i+1]);
+                i ++;
+            }
+            else if(argv[i][1] == 'u'){
+                extra+=" -mus-jobs="+string(argv[i+1]);
+                i ++;
+            }
+            else if(argv[i][1] == 'c'){
+                extra+=" -iis="+string(argv[i+1]);
+                i ++;
+            }
+            else if(argv[i][1] == 'j'){
+                extra+=" -jobs="+string(argv[i+1]);
+                i ++;
+            }
+            else if(argv[i][1] == 'g'){
+                extra+=" -cfg-cache="+string(argv[i+1]);
+                i ++;
+            }
+            else if(argv[i][1] == 'z'){
+                extra+=" -lazy-cfg";
+            }
+            else if(argv[i][1] == 'e'){
+                extra+=" -summary";
+            }
+            else if(argv[i][1] == 'x'){
+                extra+=" -max-loc="+string(argv[i+1]);
+                i ++;
+            }
             else{
                 printUsage();
                 exit(1); 
@@ -98,7 +142,7 @@ int main(int argc, char* argv[]){
 
     string name = split(filename);
     compile(name, output);
-    opt(name, bound, precision, mode, func, expression, output);
+    opt(name, bound, precision, mode, func, expression, output, extra);
     return 0;
 }
 
@@ -110,6 +154,18 @@ void printUsage(){
     cout<<"\t-t\t\tBRICK display test informations while checking"<<endl;
     cout<<"\t-a\t\tset mode in which BRICK check assert only"<<endl;
     cout<<"\t-d\t\tset mode in which BRICK check domain error only"<<endl;
+    cout<<"\t-w\t\tuse the pairwise at-most-one encoding instead of the sequential one"<<endl;
+    cout<<"\t-i\t\tcheck all targets together by incremental deepening (linear mode)"<<endl;
+    cout<<"\t-j <N>\t\tcheck the targets on N parallel workers"<<endl;
+    cout<<"\t-r\t\trace the backends agreeing on the semantics of the program on every path (portfolio)"<<endl;
+    cout<<"\t-n <N>\t\tpipeline the SAT path enumeration into N SMT workers (linear mode)"<<endl;
+    cout<<"\t-m <ms>\t\ttime budget of a single MUS minimisation query"<<endl;
+    cout<<"\t-u <N>\t\tenumerate several MUSes per infeasible path on N workers"<<endl;
+    cout<<"\t-c <file>\tload and save the infeasible path segments in file across runs"<<endl;
+    cout<<"\t-g <dir>\treuse the CFG built by an earlier run on the same program and options"<<endl;
+    cout<<"\t-z\t\twith -g, decode the constraints of a node only when the search reaches it (not with -c or -o)"<<endl;
+    cout<<"\t-e\t\tbuild every called function once and share it between its call sites"<<endl;
+    cout<<"\t-x <N>\t\tgive up on programs of more than N lines (default 200, 0: no limit)"<<endl;
 }
 
 void compile(string name, int o){
@@ -140,7 +196,7 @@ string doubletostring(const double d)
   return str;
 }
 
-void opt(string name, int b, double p, int m, char* f, char* e, int o){
+void opt(string name, int b, double p, int m, char* f, char* e, int o, string extra){
     string bound = "-bound=" + inttostring(b);
     string precision = "-pre=" + doubletostring(p);
     string mode = "-mode=" + inttostring(m);
@@ -152,7 +208,7 @@ void opt(string name, int b, double p, int m, char* f, char* e, int o){
     string command = "opt -load buildCFG.so"
     " -load libz3.so -load libminisat.so"
     " -load libibex.so -load libdreal.so"//-load libcapd.so 
-    " -buildCFG "+bound+" "+precision+" "+mode+" "+func+" "+output+" "+expr+"<"+name+".bc>"+" "+name+"buildCFG.bc";
+    " -buildCFG "+bound+" "+precision+" "+mode+" "+func+" "+output+extra+" "+expr+"<"+name+".bc>"+" "+name+"buildCFG.bc";
 	// g++ test_dreal.c -o test_dreal_inf -ldreal -libex -lClpSolver -lClp -lCoinUtils -lm -lcapd -lnlopt -lprim -lpthread -lstdc++ 
     if(o)    
 	   cout << command<<endl;
@@ -2,6 +2,7 @@
 // #include "printSTL.h"
 #include "llvm/Support/FileSystem.h"
 #include "CFGWriter.h"
+#include "CFGCache.h"
 #include <stack>  
 #include "llvm/Support/CommandLine.h"
 #include <time.h>
@@ -37,6 +38,42 @@ outMode("output",
 cl::opt<string>
 check("expression",
         cl::desc("check"), cl::value_desc("check"));
+cl::opt<bool>
+pairwise("pairwise",
+        cl::desc("Pairwise at-most-one encoding of the bounded graph"));
+cl::opt<bool>
+incremental("incremental",
+        cl::desc("Incremental deepening over all targets in one SAT instance"));
+cl::opt<int>
+jobs("jobs",
+        cl::desc("Number of verification workers"), cl::value_desc("jobs"), cl::init(1));
+cl::opt<bool>
+portfolio("portfolio",
+        cl::desc("Race the backends agreeing on the semantics of the program on every path"));
+cl::opt<int>
+pipeline("pipeline",
+        cl::desc("Number of SMT workers fed by the SAT path enumeration"), cl::value_desc("workers"), cl::init(0));
+cl::opt<string>
+iisFile("iis",
+        cl::desc("File storing the infeasible path segments across runs"), cl::value_desc("filename"), cl::init(""));
+cl::opt<unsigned>
+musBudget("mus-budget",
+        cl::desc("Time budget of a single MUS minimisation query in ms"), cl::value_desc("ms"), cl::init(0));
+cl::opt<int>
+musJobs("mus-jobs",
+        cl::desc("Enumerate several MUSes per infeasible path on this many workers"), cl::value_desc("workers"), cl::init(0));
+cl::opt<string>
+cfgCache("cfg-cache",
+        cl::desc("Directory caching the built CFG across runs"), cl::value_desc("directory"), cl::init(""));
+cl::opt<bool>
+lazyCFG("lazy-cfg",
+        cl::desc("Decode the constraints of a cached CFG only when the search reaches them"));
+cl::opt<bool>
+summary("summary",
+        cl::desc("Build every called function once and share its body between the call sites"));
+cl::opt<int>
+maxLoc("max-loc",
+        cl::desc("Give up on programs of more lines, 0 for no limit"), cl::value_desc("lines"), cl::init(200));
 
 
 bool if_a(char x){
@@ -84,11 +121,11 @@ ParaVariable StringToPara(string checkstr, string funcName){
 
 void ProgramCFG::assertSpec(CFG *cfg, int line){
     for(unsigned int i=0;i<cfg->stateList.size();i++){
-        if(cfg->stateList[i].error!=Noerr) continue;
-        for(vector<int>::iterator it=cfg->stateList[i].locList.begin();it<cfg->stateList[i].locList.end();it++){
+        if(cfg->stateList[i]->error!=Noerr) continue;
+        for(vector<int>::iterator it=cfg->stateList[i]->locList.begin();it<cfg->stateList[i]->locList.end();it++){
             if(*it==lineNo){
-                target.push_back(cfg->stateList[i].ID);
-                cfg->stateList[i].error=Spec;
+                target.push_back(cfg->stateList[i]->ID);
+                cfg->stateList[i]->error=Spec;
                 break;
             }
         }
@@ -112,20 +149,64 @@ ProgramCFG::ProgramCFG(Module &m):M(m){
     //Create the cfg Structure
     CFG* cfg = new CFG();
     // cfg->setUnlinear();
-    buildProgramCFG(m, cfg);
-    cfg->initial();
+    CFGCache *cache = NULL;
+    bool cached = false;
+    //the IIS store hashes and the CFG printer reads every node, a lazy load would decode them all anyway
+    bool lazy = lazyCFG;
+    if(lazy&&(iisFile!=""||outMode==1)){
+        errs() << "Warning: -lazy-cfg has no effect with -iis or -output=1, the cached CFG is loaded eagerly\n";
+        lazy = false;
+    }
+    if(cfgCache!=""){
+        string options = "builder="+ConvertToString(CFG_BUILDER)+" bound="+ConvertToString(bound)+" pre="+ConvertToString(prec)+" mode="+ConvertToString(modeNo)
+            +" func="+funcname+" line="+ConvertToString(lineNo)+" expression="+check
+            +" summary="+ConvertToString(summary);
+        cache = new CFGCache(cfgCache, m, options);
+        dbg = new DebugInfo(funcname);
+        cached = cache->load(cfg, target, dbg, lazy);
+        if(!cached){
+            delete dbg;
+            delete cfg;
+            cfg = new CFG();
+            target.clear();
+        }
+        else{
+            errs() << "#CFG cache hit: \t" << cache->path() << (lazy?" (lazy)":"") << "\n";
+            if(lazy){
+                cfg->setLazySource(cache);
+                cache = NULL;
+            }
+        }
+    }
+    else if(lazy)
+        errs() << "Warning: -lazy-cfg needs -cfg-cache, the CFG is built eagerly\n";
+    if(!cached){
+        buildProgramCFG(m, cfg);
+        clearParsers();
+        cfg->initial();
+        if(cache)
+            cache->save(cfg, target, dbg);
+    }
+    delete cache;
     if(outMode==1)
         cfg->print();
 
     finish=clock();
     double buildTime = 1000*(double)(finish-start)/CLOCKS_PER_SEC;
     errs() << "#BUILDCFG Time: \t" << ConvertToString(buildTime) << "ms\n";
+    errs() << "#BUILDCFG Arena: \t" << (unsigned long)cfg->arena.bytesUsed() << " bytes in "
+           << (unsigned long)cfg->arena.size() << " objects (" << (unsigned long)cfg->arena.bytesReserved() << " reserved)\n";
+    errs() << "#BUILDCFG Terms: \t" << cfg->terms.size() << " terms over " << cfg->terms.variables() << " variables\n";
+    errs() << "#BUILDCFG Size: \t" << dbg->loc << " LOC, " << (unsigned)cfg->stateList.size() << " states, " << (unsigned)cfg->transitionList.size() << " transitions\n";
+    char build_mem[64];
+    sprintf(build_mem, "#BUILDCFG Memory: \t%.2f MB\n", memUsedPeak());
+    errs() << build_mem;
 
     if(outMode)
         dbg->print();
     
-    if(dbg->loc>200){
-        errs()<<"Loc larger than 200!\n";
+    if(maxLoc>0&&dbg->loc>maxLoc){
+        errs()<<"Loc larger than "<<maxLoc<<"!\n";
         exit(-1);
     }
     int inputbound=bound;
@@ -133,7 +214,23 @@ ProgramCFG::ProgramCFG(Module &m):M(m){
     start=clock();
 
     BoundedVerification verify(cfg,inputbound,target,prec,dbg,output);
+    verify.setPairwiseAMO(pairwise);
+    verify.setIncremental(incremental);
+    verify.setJobs(jobs);
+    verify.setPortfolio(portfolio);
+    verify.setPipeline(pipeline);
+    MUS_BUDGET = musBudget;
+    if(musJobs>0){
+        UC_LEVEL = 1;
+        MUS_JOBS = musJobs;
+    }
+    IISStore *iisStore = NULL;
+    if(iisFile!=""){
+        iisStore = new IISStore(iisFile, cfg);
+        verify.setIISStore(iisStore);
+    }
     verify.check(check);
+    delete iisStore;
 
     double solver_time = verify.getSolverTime();
     /*
@@ -254,7 +351,7 @@ void  ProgramCFG::setFuncVariable(const Function *F,string func, CFG* cfg, bool
                 Variable var(varName, ID, type, numBits);
                 cfg->variableList.push_back(var);
             }
-            else
+            else if(!cfg->summarize)   //a shared body gets its arguments from the first call
                 errs()<<"1:setFuncVariable error 10086!!\t"<<varName<<"\n";
         }
     }
@@ -262,6 +359,7 @@ void  ProgramCFG::setFuncVariable(const Function *F,string func, CFG* cfg, bool
 
 //build program cfg in the main source file !
 void  ProgramCFG::buildProgramCFG(Module &m, CFG* cfg){
+        cfg->summarize = summary;
         if(funcname == "main"){
             cfg->startFunc = "main";
             dbg = new DebugInfo("main");
@@ -276,9 +374,10 @@ void  ProgramCFG::buildProgramCFG(Module &m, CFG* cfg){
             cfg->startFunc = funcname;
             dbg = new DebugInfo(funcname);
 
-            map<string ,int >::iterator it=cfg->funcTime.find(funcname);
+            Symbol func = symbolTable.intern(funcname);
+            unordered_map<Symbol,int >::iterator it=cfg->funcTime.find(func);
             if(it==cfg->funcTime.end())
-                cfg->funcTime.insert(pair<string,int>(funcname,0));
+                cfg->funcTime.insert(pair<Symbol,int>(func,0));
             else
                 errs()<<"ProgramCFG::buildProgramCFG error "<<funcname<<"\n";
 
@@ -301,6 +400,23 @@ void ProgramCFG::readFunc(string funcName, CFG *cfg, int time){
     }
 }
 
+InstParser &ProgramCFG::getParser(const Function *F){
+    map<const Function*, FuncParser*>::iterator it = parsers.find(F);
+    if(it!=parsers.end())
+        return it->second->parser;
+    FuncParser *p = new FuncParser(F);
+    p->parser.setPrecision(precision);
+    p->parser.setMode(mode);
+    parsers[F] = p;
+    return p->parser;
+}
+
+void ProgramCFG::clearParsers(){
+    for(map<const Function*, FuncParser*>::iterator it = parsers.begin(); it != parsers.end(); it++)
+        delete it->second;
+    parsers.clear();
+}
+
 void ProgramCFG::readBasicblock(BasicBlock *b, CFG *cfg, int time){
     string callFunc;
 
@@ -325,17 +441,14 @@ void ProgramCFG::readBasicblock(BasicBlock *b, CFG *cfg, int time){
         string  str = ConvertToString(cfg->counter_s_state);
         cfg->counter_s_state++;
         string name = "s"+str;
-        State* s = new State(false, id, name, func);
+        State* s = cfg->arena.make<State>(false, id, name, func);
         while(!cfg->initialCons.empty()){
             Constraint cTemp = cfg->initialCons.front();
             cfg->initialCons.pop_front();
             s->consList.push_back(cTemp);
         }
         cfg->stateList.resize(id+1);
-        raw_ostream &ROS = errs();
-        formatted_raw_ostream OS(ROS);
-
-        global_CFG.InsertCFGState(cfg->counter_state,name,func);
+        InstParser &W = getParser(F);
             
 //        errs()<<"0:readBasicblock "<<func<<"\n";
         if(func==cfg->startFunc && b==F->begin()){
@@ -352,11 +465,6 @@ void ProgramCFG::readBasicblock(BasicBlock *b, CFG *cfg, int time){
         for(BasicBlock::iterator it = b->begin(); it != it_end; it ++){  
 
             const Instruction* I = dyn_cast<Instruction>(it);
-            SlotTracker SlotTable(F);
-            const Module* M = F?F->getParent():nullptr;
-            InstParser W(OS, SlotTable, M, nullptr);
-            W.setPrecision(precision);
-            W.setMode(mode);
 
             // errs()<<"0.InL:";W.printInstructionLine(*I);
                 //create the LabelMap
@@ -370,7 +478,7 @@ void ProgramCFG::readBasicblock(BasicBlock *b, CFG *cfg, int time){
                 else if(s->level>bound){
                     if(cfg->stateList.size()<id)
                         cfg->stateList.resize(id);
-                    cfg->stateList[s->ID]=(*s);
+                    cfg->stateList[s->ID]=s;
                     return;
                 }
             } 
@@ -395,31 +503,42 @@ void ProgramCFG::readBasicblock(BasicBlock *b, CFG *cfg, int time){
                 }
             // **************************Deal with Function isDefined****************************
                 if(!f->isDeclaration()) {
-                    cfg->stateList[s->ID]=(*s);
+                    cfg->stateList[s->ID]=s;
 
                     string callFunc = f->getName();
-                    map<string ,int >::iterator it=cfg->funcTime.find(callFunc);
+                    Symbol callSym = symbolTable.intern(callFunc);
+                    //site>0: the body built for an earlier call is shared, nothing is read
+                    int site = cfg->callSite.back();
+                    unordered_map<Symbol,int >::iterator it=cfg->funcTime.find(callSym);
                     int t = 0;
                     if(it==cfg->funcTime.end())
-                        cfg->funcTime.insert(pair<string,int>(callFunc,t));
-                    else
+                        cfg->funcTime.insert(pair<Symbol,int>(callSym,t));
+                    else if(site<0)
                         t = ++it->second;
 
-                    readFunc(callFunc, cfg, t);
+                    if(site<=0)
+                        readFunc(callFunc, cfg, t);
+                    if(site==0)
+                        cfg->summaries[callSym].built = true;
                     id = cfg->counter_state++;
                     string  str = ConvertToString(cfg->counter_s_state);
                     cfg->counter_s_state++;
                     name = "s"+str;
-                    global_CFG.InsertCFGState(id,name,func);
 
                     string funcName = callFunc;
                     if(t>0)
                         funcName = callFunc+".t"+ConvertToString(t);
 
-                    s = new State(false, id, name, func);
+                    s = cfg->arena.make<State>(false, id, name, func);
                     cfg->stateList.resize(id+1);
-                    bool hasFromS = W.InsertCFGLabel(cfg, b, s, func, funcName+".ret",true);
+                    string retLabel = funcName+".ret";
+                    if(site>0){
+                        retLabel = funcName+".site"+ConvertToString(site)+".ret";
+                        cfg->bindReturns(callFunc, site, cfg->retVar.back(), retLabel);
+                    }
+                    bool hasFromS = W.InsertCFGLabel(cfg, b, s, func, retLabel,true);
                     cfg->retVar.pop_back();
+                    cfg->callSite.pop_back();
                     if(!hasFromS){
                         cfg->counter_state--;
                         cfg->counter_s_state--;
@@ -428,13 +547,13 @@ void ProgramCFG::readBasicblock(BasicBlock *b, CFG *cfg, int time){
                     else if(s->level>bound){
                         if(cfg->stateList.size()<id)
                             cfg->stateList.resize(id);
-                        cfg->stateList[s->ID]=(*s);
+                        cfg->stateList[s->ID]=s;
                         return;
                     }
                 }
             }
         }
-        cfg->stateList[s->ID] = (*s);
+        cfg->stateList[s->ID] = s;
     }
 }
 
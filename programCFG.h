@@ -89,7 +89,7 @@ struct CFGNode{
                 //create the constraint table(NOT TRANSITION)
 //                counter_state = W.setConstraint(cfg, s, I, func, counter_state);
             } 
-            cfg->stateList.push_back(*s);
+            cfg->stateList.push_back(s);
 	    
         }else {
             ;
@@ -159,6 +159,16 @@ class ProgramCFG{
         void readFunc(string funcName, CFG *cfg, int time);
         //build basicBlock CFG
         void readBasicblock(BasicBlock *b, CFG *cfg, int time);
+        //slot numbering and parser of a function, shared by all its blocks and call-site copies
+        struct FuncParser{
+            SlotTracker slots;
+            formatted_raw_ostream os;
+            InstParser parser;
+            FuncParser(const Function *F):slots(F),os(errs()),parser(os, slots, F->getParent(), nullptr){}
+        };
+        map<const Function*, FuncParser*> parsers;
+        InstParser &getParser(const Function *F);
+        void clearParsers();
         void createSucc(BasicBlock *v);
         void bfs(CFGNode *v);
         CFGNode* root;
@@ -173,6 +183,7 @@ class ProgramCFG{
     public:
         ProgramCFG(Module &m);
         ~ProgramCFG(){
+            clearParsers();
             if(dbg)
                 delete dbg;
             dbg = NULL;